@@ -0,0 +1,164 @@
+// admission.cpp : single-flight and admission queue of a handler. (TSequenceMap::Bind, GetFlightStats, GetAdmissionStats, sequence_map.h)
+//
+// 'load' (recipe download) is bound single-flight, at most 2 running, fifo queue of 2.
+// single-flight : 3 callers of the same recipe share 1 run. (hit 2, miss 1)
+// admission : 2 start at once, 2 are queued and start as running ones finish, the 5th is rejected.
+//		the rejected recipe is requested again later : it must run. (not attach to a flight left behind by the rejection)
+// shutdown : a driver is destroyed with requests running and queued. callers get broken_promise, slots are released,
+//		and the next request runs. (not attach to a flight of the dropped request)
+//
+
+#include <chrono>
+#include <functional>
+#include <future>
+#include <optional>
+#include <vector>
+
+#include <fmt/core.h>
+#include <fmt/chrono.h>
+
+#include "gtl/sequence.h"
+#include "gtl/sequence_map.h"
+#include "gtl/sequence_sleeper.h"
+
+namespace gtl::seq::test {
+
+	using namespace std::literals;
+	namespace chrono = std::chrono;
+
+	using seq_t = TSequence<int>;
+	using coro_t = seq_t::coro_t;
+	using seq_map_t = TSequenceMap<int, int>;
+
+	struct sLoader {
+		std::vector<int> started;	// recipes, in start order
+	};
+
+	coro_t Load(seq_t& seq, sLoader& loader, int recipe) {
+		loader.started.push_back(recipe);
+		co_await seq.WaitFor(20ms);
+		co_return recipe * 100;
+	}
+
+	void Bind(seq_map_t& unit, sLoader& loader) {
+		unit.Bind("load", [&loader](seq_t& seq, int&& recipe) { return Load(seq, loader, recipe); },
+			2, seq_map_t::sAdmissionOption{ .policy = seq_map_t::eAdmission::fifo, .queue_depth = 2, .fnPriority = {} }, true);
+	}
+
+	int Check(bool bOK, std::string_view what) {
+		fmt::print("{} ({})\n", what, bOK ? "OK" : "FAIL");
+		return bOK ? 0 : 1;
+	}
+
+	coro_t Scenario(seq_t& seq, seq_map_t& top, sLoader& loader) {
+		int nFail{};
+
+		// single-flight
+		{
+			std::vector<TAsyncFuture<int>> futures;
+			for (int i = 0; i < 3; i++)
+				futures.push_back(top.CallSequence("", "load", 7));
+			int sum{};
+			for (auto& future : futures)
+				sum += co_await std::move(future);
+			auto const stats = top.GetFlightStats("load");
+			nFail += Check(sum == 3 * 700 and loader.started == std::vector{7} and stats.nHit == 2 and stats.nMiss == 1,
+				fmt::format("single-flight : 3 callers, {} run(s), hit {}, miss {}", loader.started.size(), stats.nHit, stats.nMiss));
+		}
+
+		// admission
+		{
+			loader.started.clear();
+			std::vector<TAsyncFuture<int>> futures;
+			bool bRejected{};
+			for (int recipe : { 1, 2, 3, 4, 5 }) {
+				try {
+					futures.push_back(top.CallSequence("", "load", int{recipe}));
+				}
+				catch (std::exception const&) {
+					bRejected = recipe == 5;
+				}
+			}
+			auto const queued = top.GetAdmissionStats("load");
+			int sum{};
+			for (auto& future : futures)
+				sum += co_await std::move(future);
+			auto const stats = top.GetAdmissionStats("load");
+			nFail += Check(bRejected and queued.nRunning == 2 and queued.nQueued == 2 and sum == 1000 and loader.started == std::vector{1, 2, 3, 4}
+				and stats.nStarted == 1+2 and stats.nDequeued == 2 and stats.nRejected == 1 and stats.nRunning == 0,
+				fmt::format("admission : started {}, dequeued {}, rejected {}, max queued {}, max wait {}", stats.nStarted, stats.nDequeued, stats.nRejected,
+					stats.nMaxQueued, chrono::duration_cast<chrono::milliseconds>(stats.tWaitMax)));
+
+			// the rejected one again
+			loader.started.clear();
+			auto future = top.CallSequence("", "load", 5);
+			auto const t0 = chrono::steady_clock::now();
+			while (!future.IsReady() and chrono::steady_clock::now() - t0 < 1s)
+				co_await seq.WaitFor(5ms);
+			int const result = future.IsReady() ? co_await std::move(future) : 0;
+			nFail += Check(result == 500 and loader.started == std::vector{5}, fmt::format("rejected recipe requested again : result {}", result));
+		}
+
+		co_return int{nFail};
+	}
+
+	/// @brief requests pending when the driver is destroyed
+	int Shutdown(sLoader& loader) {
+		int nFail{};
+		seq_map_t line("line");
+		Bind(line, loader);
+		std::vector<TAsyncFuture<int>> futures;
+		{
+			seq_t driver("line");
+			line.SetSequenceDriver(&driver);
+			for (int recipe : { 1, 1, 2, 3 })	// 1 (and its attached caller), 2 running. 3 queued
+				futures.push_back(line.CallSequence(&driver, "", "load", int{recipe}));
+			driver.Dispatch();
+		}
+		line.SetSequenceDriver(nullptr);
+		size_t nBroken{};
+		for (auto& future : futures) {
+			try {
+				if (future.IsReady())
+					future.Get();
+			}
+			catch (std::future_error const& e) {
+				nBroken += e.code() == std::future_errc::broken_promise;
+			}
+		}
+		auto const stats = line.GetAdmissionStats("load");
+		nFail += Check(nBroken == futures.size() and stats.nRunning == 0 and stats.nQueued == 0,
+			fmt::format("shutdown : {} of {} callers got broken_promise, running {}, queued {}", nBroken, futures.size(), stats.nRunning, stats.nQueued));
+
+		seq_t driver("line");
+		line.SetSequenceDriver(&driver);
+		auto future = line.CallSequence(&driver, "", "load", 1);
+		auto const t0 = chrono::steady_clock::now();
+		while ((!driver.IsDone() or !future.IsReady()) and chrono::steady_clock::now() - t0 < 1s)
+			xSleeper{}.SleepUntil(std::min(driver.Dispatch(), gtl::seq::clock_t::now() + 5ms));
+		int const result = future.IsReady() ? future.Get() : 0;
+		nFail += Check(result == 100, fmt::format("after shutdown : result {}", result));
+		line.SetSequenceDriver(nullptr);
+		return nFail;
+	}
+
+}
+
+int main() {
+	using namespace gtl::seq;
+	using namespace gtl::seq::test;
+
+	sLoader loader;
+	seq_t driver("driver");
+	seq_map_t top("top", driver);
+	Bind(top, loader);
+
+	auto future = driver.CreateChildSequence("scenario", 0, std::function<coro_t(seq_t&)>([&top, &loader](seq_t& seq) { return Scenario(seq, top, loader); }));
+	xSleeper sleeper;
+	driver.Run(sleeper);
+
+	int nFail = future.get();
+	nFail += Shutdown(loader);
+	fmt::print("{}\n", nFail ? "FAILED" : "all OK");
+	return nFail ? 1 : 0;
+}
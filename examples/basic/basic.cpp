@@ -8,6 +8,7 @@
 #include <fmt/xchar.h>
 #include <fmt/chrono.h>
 #include "gtl/sequence.h"
+#include "gtl/sequence_sleeper.h"
 
 namespace gtl::seq::test {
 
@@ -83,7 +84,8 @@ namespace gtl::seq::test {
 
 		// step 2
 		auto t1 = gtl::seq::clock_t::now();
-		fmt::print("{}: Child 1 Done, Result : {},  in {}\n", funcname, f.get(), chrono::duration_cast<chrono::milliseconds>(t1-t0));
+		auto result = f.get();
+		fmt::print("{}: Child 1 Done, Result : {},  in {}\n", funcname, result, chrono::duration_cast<chrono::milliseconds>(t1-t0));
 
 		auto t2 = gtl::seq::clock_t::now();
 		fmt::print("{}: WaitFor 100ms, {}\n", funcname, chrono::duration_cast<chrono::milliseconds>(t2 - t1));
@@ -92,7 +94,7 @@ namespace gtl::seq::test {
 		// step 3
 		fmt::print("{}: End\n", funcname);
 
-		co_return f.get();
+		co_return result;
 	}
 
 	coro_t Child1(seq_t& seq) {
@@ -192,14 +194,16 @@ int main() {
 
 			// start tree sequence
 			driver.CreateChildSequence("TreeSequence", &TopSeq);
-			do {
-				gtl::seq::clock_t::time_point t = driver.Dispatch();
-				if (driver.IsDone())
-					break;
-				if (auto ts = t - gtl::seq::clock_t::now(); ts > 3s)
-					t = gtl::seq::clock_t::now() + 3s;
-				std::this_thread::sleep_until(t);
-			} while (!driver.IsDone());
+
+			// dispatch loop, sleep (high resolution timer) and spin
+			gtl::seq::xHybridSleeper sleeper;
+			driver.Run(sleeper);
+
+			auto const& histogram = sleeper.GetJitterHistogram();
+			fmt::print("wake-up jitter : count {}, mean {}, p99 {}, max {}\n", histogram.count,
+				chrono::duration_cast<chrono::microseconds>(histogram.Mean()),
+				chrono::duration_cast<chrono::microseconds>(histogram.Percentile(0.99)),
+				chrono::duration_cast<chrono::microseconds>(histogram.max));
 
 			fmt::print("End : Tree Sequence\n");
 		} catch (std::exception& e) {
@@ -0,0 +1,103 @@
+// call.cpp : calling sequences of other units. (TSequenceMap::CallSequence, CreateSequence, sequence_map.h)
+//
+// local call : co_await CallSequence() of a unit on the same driver. the caller's next WaitFor() must wait its full time.
+//		(the caller is resumed once, not again by a late wake-up of the result)
+// remote call : CreateSequence() of a unit pinned to other driver (thread). the caller's WaitForChild() waits for the result.
+//
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <optional>
+#include <thread>
+
+#include <fmt/core.h>
+#include <fmt/chrono.h>
+
+#include "gtl/sequence.h"
+#include "gtl/sequence_map.h"
+#include "gtl/sequence_sleeper.h"
+
+namespace gtl::seq::test {
+
+	using namespace std::literals;
+	namespace chrono = std::chrono;
+
+	using seq_t = TSequence<int>;
+	using coro_t = seq_t::coro_t;
+	using seq_map_t = TSequenceMap<int, int>;
+
+	coro_t Twice(seq_t& seq, int param) {
+		co_await seq.WaitFor(10ms);
+		co_return param * 2;
+	}
+
+	coro_t Caller(seq_t& seq, seq_map_t& top) {
+		int nFail{};
+
+		// local call, then a plain wait
+		{
+			auto result = co_await top.CallSequence("", "twice", 21);
+			auto t0 = chrono::steady_clock::now();
+			co_await seq.WaitFor(200ms);
+			auto elapsed = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - t0);
+			bool const bOK = result == 42 and elapsed >= 200ms;
+			nFail += !bOK;
+			fmt::print("local call : result {}, WaitFor(200ms) after it took {} ({})\n", result, elapsed, bOK ? "OK" : "FAIL");
+		}
+
+		// remote call. the result is a child of this sequence
+		{
+			auto future = top.CreateSequence(nullptr, "station", "twice", {}, 50);
+			co_await seq.WaitForChild();
+			bool const bReady = future.wait_for(0s) == std::future_status::ready;
+			int const result = bReady ? future.get() : 0;
+			bool const bOK = bReady and result == 100;
+			nFail += !bOK;
+			fmt::print("remote call : {}, result {} ({})\n", bReady ? "done after WaitForChild()" : "NOT done after WaitForChild()", result, bOK ? "OK" : "FAIL");
+		}
+
+		co_return int{nFail};
+	}
+
+}
+
+int main() {
+	using namespace gtl::seq;
+	using namespace gtl::seq::test;
+
+	seq_t driver("driver");
+	seq_map_t top("top", driver);
+	seq_map_t station("station", top);
+	std::function<coro_t(seq_t&, int&&)> twice = [](seq_t& seq, int&& param) { return Twice(seq, param); };
+	top.Bind("twice", twice);
+	station.Bind("twice", twice);
+
+	// station runs on its own driver thread
+	std::optional<seq_t> driverStation;
+	std::atomic<bool> bReady{};
+	std::jthread thread([&](std::stop_token stop) {
+		driverStation.emplace("station");	// (owned by this thread)
+		xSleeper sleeper;
+		driverStation->SetNotifier([&sleeper] { sleeper.Interrupt(); });
+		bReady = true;
+		bReady.notify_one();
+		while (!stop.stop_requested())
+			sleeper.SleepUntil(std::min(driverStation->Dispatch(), gtl::seq::clock_t::now() + 10ms));
+		driverStation.reset();
+	});
+	bReady.wait(false);
+	station.SetSequenceDriver(&*driverStation);
+
+	auto future = driver.CreateChildSequence("caller", 0, std::function<coro_t(seq_t&)>([&top](seq_t& seq) { return Caller(seq, top); }));
+	xSleeper sleeper;
+	driver.Run(sleeper);
+
+	thread.request_stop();
+	thread.join();
+	station.SetSequenceDriver(nullptr);
+
+	int nFail = future.get();
+	fmt::print("{}\n", nFail ? "FAILED" : "all OK");
+	return nFail ? 1 : 0;
+}
@@ -0,0 +1,111 @@
+// channel.cpp : data acquisition thread feeding a sequence through a lock-free channel. (TChannel, sequence_channel.h)
+//
+// the DAQ thread samples at 20 kHz for 1 s, and sends every sample with TrySend(). (no lock, no allocation. retries while full)
+// the consumer sequence parks on ReceiveMany() while the channel is empty, and takes whatever arrived at once when woken up.
+// the channel holds 64 samples, so the producer also retries while the consumer is late.
+// checked : every sample arrives, once, in order.
+//
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <thread>
+
+#include <fmt/core.h>
+
+#include "gtl/sequence.h"
+#include "gtl/sequence_channel.h"
+#include "gtl/sequence_sleeper.h"
+
+namespace gtl::seq::test {
+
+	using namespace std::literals;
+	namespace chrono = std::chrono;
+
+	using seq_t = TSequence<int>;
+	using coro_t = seq_t::coro_t;
+
+	constexpr auto s_period = 50us;	// 20 kHz
+	constexpr uint64_t s_nSample = 20'000;
+
+	struct sSample {
+		uint64_t index{};
+		chrono::steady_clock::time_point tSampled;
+		double value{};
+	};
+	using channel_t = TChannelSPSC<sSample>;
+
+	struct sResult {
+		uint64_t nReceived{};
+		uint64_t nOutOfOrder{};
+		uint64_t nWake{};		// ReceiveMany() calls
+		size_t nBatchMax{};
+		chrono::steady_clock::duration latencyMax{};
+		chrono::steady_clock::duration latencySum{};
+	};
+
+	/// @brief DAQ thread. paced by deadline, not by sleep time. (busy-waits between samples)
+	uint64_t Acquire(channel_t& channel) {
+		uint64_t nFull{};
+		auto t = chrono::steady_clock::now();
+		for (uint64_t i = 0; i < s_nSample; i++) {
+			t += s_period;
+			while (chrono::steady_clock::now() < t)
+				;
+			sSample sample{ .index = i, .tSampled = chrono::steady_clock::now(), .value = (double)(i % 1000) * 0.001 };
+			while (!channel.TrySend(sample)) {
+				nFull++;
+				std::this_thread::yield();
+			}
+		}
+		return nFull;
+	}
+
+	coro_t Consume(seq_t&, channel_t& channel, sResult& result) {
+		std::array<sSample, 256> buffer;
+		while (result.nReceived < s_nSample) {
+			auto n = co_await channel.ReceiveMany(buffer);
+			auto const tNow = chrono::steady_clock::now();
+			result.nWake++;
+			result.nBatchMax = std::max(result.nBatchMax, n);
+			for (auto const& sample : std::span(buffer).first(n)) {
+				if (sample.index != result.nReceived)
+					result.nOutOfOrder++;
+				result.nReceived++;
+				auto const latency = tNow - sample.tSampled;
+				result.latencyMax = std::max(result.latencyMax, latency);
+				result.latencySum += latency;
+			}
+		}
+		co_return 0;
+	}
+
+}
+
+int main() {
+	using namespace gtl::seq;
+	using namespace gtl::seq::test;
+
+	channel_t channel(64);
+	sResult result;
+
+	seq_t driver("driver");
+	driver.CreateChildSequence("consumer", 0, std::function<coro_t(seq_t&)>([&](seq_t& seq) { return Consume(seq, channel, result); }));
+
+	uint64_t nFull{};
+	std::jthread daq([&] { nFull = Acquire(channel); });
+	xSleeper sleeper;	// woken up by the channel when the consumer is parked
+	driver.Run(sleeper);
+	daq.join();
+
+	auto us = [](auto d) { return chrono::duration<double, std::micro>(d).count(); };
+	bool const bOK = result.nReceived == s_nSample and result.nOutOfOrder == 0 and channel.IsEmpty();
+	fmt::print("received {} / {}, out of order {}, producer retries (full) {}\n", result.nReceived, s_nSample, result.nOutOfOrder, nFull);
+	fmt::print("wake-ups {} (max {} samples at once), latency avg {:.1f} us, max {:.1f} us\n",
+		result.nWake, result.nBatchMax, us(result.latencySum) / std::max<uint64_t>(result.nReceived, 1), us(result.latencyMax));
+	fmt::print("{}\n", bOK ? "OK" : "FAIL");
+	return bOK ? 0 : 1;
+}
@@ -0,0 +1,77 @@
+// depth.cpp : dispatch cost of deep sequence trees. (a chain of nested sequences, ex, recursive retry)
+//
+// each level creates one child and waits for it. the leaf ticks nTick times.
+// the driver pops due sequences from its ready heap, so a tick costs the same at any depth, and nothing recurses on the tree.
+//
+
+#include <chrono>
+#include <functional>
+
+#include <fmt/core.h>
+#include <fmt/chrono.h>
+
+#include "gtl/sequence.h"
+
+namespace gtl::seq::test {
+
+	using namespace std::literals;
+	namespace chrono = std::chrono;
+
+	using seq_t = gtl::seq::TSequence<int>;
+	using coro_t = seq_t::coro_t;
+
+	constexpr int nTick = 10'000;
+
+	coro_t Nest(seq_t& seq, int depth);
+	std::function<coro_t(seq_t&, int&&)> const fnNest = [](seq_t& seq, int&& depth) { return Nest(seq, depth); };
+
+	coro_t Nest(seq_t& seq, int depth) {
+		if (depth > 1) {
+			auto future = seq.CreateChildSequence<int>("nest", 0, fnNest, depth-1);
+			co_await seq.WaitForChild();
+			co_return future.get() + 1;
+		}
+		// leaf
+		for (int i = 0; i < nTick; i++)
+			co_await seq.WaitFor(1ns);	// next tick
+		co_return 1;
+	}
+
+	void Measure(int depth) {
+		using clock = chrono::steady_clock;
+		auto us = [](auto d) { return chrono::duration_cast<chrono::microseconds>(d); };
+
+		auto driver = std::make_unique<seq_t>("driver");
+		auto t0 = clock::now();
+		auto future = driver->CreateChildSequence<int>("nest", 0, fnNest, int{depth});
+		driver->Dispatch();	// builds the chain. (each level creates its child in the same tick)
+		auto t1 = clock::now();
+
+		// leaf ticks
+		for (int i = 1; i < nTick; i++)
+			driver->Dispatch();
+		auto t2 = clock::now();
+
+		// last tick. leaf is done, and all levels are resumed and done one after another
+		driver->Dispatch();
+		auto t3 = clock::now();
+		auto const result = future.get();
+
+		// tear down a chain still running
+		driver->CreateChildSequence<int>("nest", 0, fnNest, int{depth});
+		driver->Dispatch();
+		auto t4 = clock::now();
+		driver.reset();
+		auto t5 = clock::now();
+
+		fmt::print("depth {:>7} : build {:>9}, tick {:>7.1f} ns, unwind {:>9}, destroy {:>9}. (result {})\n",
+			depth, us(t1 - t0), chrono::duration<double, std::nano>(t2 - t1).count() / (nTick-1), us(t3 - t2), us(t5 - t4), result);
+	}
+
+}
+
+int main() {
+	using namespace gtl::seq::test;
+	for (int depth : { 10, 1'000, 100'000 })
+		Measure(depth);
+}
@@ -0,0 +1,156 @@
+// generator.cpp : streaming values with co_yield. (TGenerator / TStream, sequence_generator.h)
+//
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <numeric>
+#include <thread>
+
+#include <fmt/core.h>
+#include <fmt/chrono.h>
+
+#include "gtl/sequence.h"
+
+//-----------------------------------------------------------------------------
+// allocation counter. replaces every form of operator new/delete. (plain, array, nothrow, aligned)
+// a block keeps the pointer returned by malloc just before itself, so any delete can free any new.
+static std::atomic<size_t> s_nAlloc{};
+
+static void* Alloc(size_t size, size_t align = __STDCPP_DEFAULT_NEW_ALIGNMENT__) noexcept {
+	align = std::max<size_t>(align, sizeof(void*));
+	auto* raw = (char*)std::malloc(size + align + sizeof(void*));
+	if (!raw)
+		return nullptr;
+	auto* p = (char*)(((uintptr_t)raw + sizeof(void*) + align - 1) & ~(uintptr_t)(align - 1));
+	((void**)p)[-1] = raw;
+	s_nAlloc++;
+	return p;
+}
+static void* AllocOrThrow(size_t size, size_t align = __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+	if (auto* p = Alloc(size, align))
+		return p;
+	throw std::bad_alloc();
+}
+static void Free(void* p) noexcept {
+	if (p)
+		std::free(((void**)p)[-1]);
+}
+
+void* operator new(size_t size) { return AllocOrThrow(size); }
+void* operator new[](size_t size) { return AllocOrThrow(size); }
+void* operator new(size_t size, std::nothrow_t const&) noexcept { return Alloc(size); }
+void* operator new[](size_t size, std::nothrow_t const&) noexcept { return Alloc(size); }
+void* operator new(size_t size, std::align_val_t align) { return AllocOrThrow(size, (size_t)align); }
+void* operator new[](size_t size, std::align_val_t align) { return AllocOrThrow(size, (size_t)align); }
+void* operator new(size_t size, std::align_val_t align, std::nothrow_t const&) noexcept { return Alloc(size, (size_t)align); }
+void* operator new[](size_t size, std::align_val_t align, std::nothrow_t const&) noexcept { return Alloc(size, (size_t)align); }
+void operator delete(void* p) noexcept { Free(p); }
+void operator delete[](void* p) noexcept { Free(p); }
+void operator delete(void* p, size_t) noexcept { Free(p); }
+void operator delete[](void* p, size_t) noexcept { Free(p); }
+void operator delete(void* p, std::nothrow_t const&) noexcept { Free(p); }
+void operator delete[](void* p, std::nothrow_t const&) noexcept { Free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { Free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { Free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { Free(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { Free(p); }
+void operator delete(void* p, std::align_val_t, std::nothrow_t const&) noexcept { Free(p); }
+void operator delete[](void* p, std::align_val_t, std::nothrow_t const&) noexcept { Free(p); }
+
+namespace gtl::seq::test {
+
+	using namespace std::literals;
+	namespace chrono = std::chrono;
+
+	using seq_t = TSequence<int>;
+	using coro_t = seq_t::coro_t;
+
+	constexpr int nSample = 100'000;
+
+	struct sSample {
+		int index{};
+		double value{};
+	};
+
+	/// @brief measurement sequence. streams samples instead of buffering the whole run.
+	TGenerator<sSample> Measure(seq_t& seq) {
+		for (int i = 0; i < nSample; i++) {
+			if (i % 10'000 == 0)
+				co_await seq.WaitFor(1ms);	// (acquisition)
+			if (!(co_yield sSample{ i, i * 0.5 }))
+				co_return;	// consumer is gone
+		}
+	}
+
+	/// @brief consumer sequence. parks while no sample.
+	/// (stream is a reference to the caller's. it must outlive the sequence)
+	coro_t Accumulate(seq_t&, TStream<sSample>&& stream) {
+		double sum{};
+		int n{};
+		auto nAlloc0 = s_nAlloc.load();
+		while (auto sample = co_await stream.Next()) {
+			sum += sample->value;
+			n++;
+		}
+		auto nAlloc = s_nAlloc.load() - nAlloc0;
+		fmt::print("sequence consumer : {} samples, sum {}, {} allocations while streaming\n", n, sum, nAlloc);
+		co_return n;
+	}
+
+	TGenerator<int> Count(seq_t&) {
+		for (int i = 0; i < 1000; i++)
+			co_yield i;
+	}
+	/// @brief endless. stops when the consumer is gone
+	TGenerator<int> CountForever(seq_t&) {
+		for (int i = 0; co_yield i; i++)
+			;
+	}
+
+}
+
+int main() {
+	using namespace gtl::seq;
+	using namespace gtl::seq::test;
+
+	// sequence -> sequence
+	{
+		seq_t driver;
+		auto stream = driver.CreateGenerator("measure", &Measure);
+		driver.CreateChildSequence("accumulate", &Accumulate, std::move(stream));
+		auto t0 = chrono::steady_clock::now();
+		while (!driver.IsDone())
+			driver.Dispatch();
+		auto t1 = chrono::steady_clock::now();
+		fmt::print("  {} ns/sample\n", chrono::duration_cast<chrono::nanoseconds>(t1 - t0).count() / nSample);
+	}
+
+	// sequence -> other thread (blocking iterator)
+	{
+		seq_t driver;
+		auto stream = driver.CreateGenerator("count", &Count);
+		std::jthread consumer([&stream] {
+			long sum{};
+			for (auto v : stream)
+				sum += v;
+			fmt::print("thread consumer : sum {} (expected {})\n", sum, 999 * 1000 / 2);
+		});
+		while (!driver.IsDone())
+			driver.Dispatch();
+	}
+
+	// consumer stops early
+	{
+		seq_t driver;
+		auto stream = driver.CreateGenerator("count", &CountForever);
+		driver.Dispatch();
+		auto v = stream.TryNext();
+		stream.Cancel();
+		while (!driver.IsDone())
+			driver.Dispatch();
+		fmt::print("cancelled after {}\n", v.value_or(-1));
+	}
+}
@@ -0,0 +1,144 @@
+// graph.cpp : task graph. nodes start when their inputs are done, and get their results. (TTaskGraph, sequence_graph.h)
+//
+// recipe : home and calibrate run in parallel. align needs both (fan-in), scan needs home only. report needs align and scan.
+// the same graph is run again. (the plan is reused)
+// errors : a node function rejecting its input before returning its coroutine, and a node failing while running.
+// co_await graph.Run() rethrows the first error, after all started nodes are done. nodes depending on a failed node don't run.
+//
+
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <stdexcept>
+#include <string>
+
+#include <fmt/core.h>
+#include <fmt/chrono.h>
+#include <fmt/ranges.h>
+
+#include "gtl/sequence.h"
+#include "gtl/sequence_graph.h"
+#include "gtl/sequence_sleeper.h"
+
+namespace gtl::seq::test {
+
+	using namespace std::literals;
+	namespace chrono = std::chrono;
+
+	using seq_t = TSequence<int>;
+	using coro_t = seq_t::coro_t;
+	using graph_t = TTaskGraph<seq_t>;
+
+	static std::atomic<int> s_nStarted{};
+
+	coro_t Step(seq_t& seq, chrono::milliseconds duration, int value) {
+		s_nStarted++;
+		co_await seq.WaitFor(duration);
+		if (value < 0)
+			throw std::runtime_error(fmt::format("{} failed", seq.GetName()));
+		co_return int{value};
+	}
+
+	/// @brief home, calibrate -> align, home -> scan, (align, scan) -> report
+	void BuildRecipe(graph_t& graph) {
+		auto home = graph.Add("home", [](seq_t& seq, auto const&) { return Step(seq, 50ms, 1); });
+		auto cal = graph.Add("calibrate", [](seq_t& seq, auto const&) { return Step(seq, 100ms, 2); });
+		auto align = graph.Add("align", [](seq_t& seq, auto const& in) { return Step(seq, 20ms, in[0] * 10 + in[1]); }, { home, cal });
+		auto scan = graph.Add("scan", [](seq_t& seq, auto const& in) { return Step(seq, 20ms, in[0] + 100); }, { home });
+		graph.Add("report", [](seq_t& seq, auto const& in) { return Step(seq, 0ms, in[0] + in[1]); }, { align, scan });
+	}
+
+	coro_t Recipe(seq_t& seq, graph_t& graph) {
+		int nFail{};
+		for (int run = 0; run < 2; run++) {
+			auto t0 = chrono::steady_clock::now();
+			auto results = co_await graph.Run(seq);
+			auto elapsed = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - t0);
+			// align = 1*10+2, scan = 1+100, report = 12+101. critical path : calibrate(100) + align(20) + report(0)
+			bool const bOK = (results == std::vector<int>{ 1, 2, 12, 101, 113 });
+			nFail += !bOK;
+			fmt::print("run {} : results {}, {} ({})\n", run, results, elapsed, bOK ? "OK" : "FAIL");
+		}
+		co_return int{nFail};
+	}
+
+	/// @return 1 if failed
+	int Check(seq_t& seq, char const* title, std::exception_ptr error, int nStartedExpected) {
+		if (!error) {
+			fmt::print("{} : not thrown (FAIL)\n", title);
+			return 1;
+		}
+		bool const bOK = s_nStarted == nStartedExpected and !seq.HasChild();
+		try {
+			std::rethrow_exception(error);
+		}
+		catch (std::exception const& e) {
+			fmt::print("{} : '{}', {} nodes started ({})\n", title, e.what(), s_nStarted.load(), bOK ? "OK" : "FAIL");
+		}
+		return !bOK;
+	}
+
+	/// @brief node function throwing before it returns a coroutine, and a node throwing while running
+	coro_t Errors(seq_t& seq) {
+		int nFail{};
+		// validate rejects its input. probe and slow run, 'after validate' doesn't. Run() returns after slow is done
+		{
+			graph_t graph;
+			auto probe = graph.Add("probe", [](seq_t& seq, auto const&) { return Step(seq, 10ms, 500); });
+			auto validate = graph.Add("validate", [](seq_t& seq, auto const& in) {
+				if (in[0] > 100)
+					throw std::invalid_argument(fmt::format("probe out of range : {}", in[0]));	// before returning the coroutine
+				return Step(seq, 0ms, in[0]);
+			}, { probe });
+			graph.Add("after validate", [](seq_t& seq, auto const& in) { return Step(seq, 0ms, in[0]); }, { validate });
+			graph.Add("slow", [](seq_t& seq, auto const&) { return Step(seq, 30ms, 1); });
+			s_nStarted = 0;
+			std::exception_ptr error;
+			try {
+				co_await graph.Run(seq);
+			}
+			catch (...) {
+				error = std::current_exception();
+			}
+			nFail += Check(seq, "rejected input", error, 2);
+		}
+		// motor fails while running. its dependent doesn't run
+		{
+			graph_t graph;
+			auto motor = graph.Add("motor", [](seq_t& seq, auto const&) { return Step(seq, 10ms, -1); });
+			graph.Add("after motor", [](seq_t& seq, auto const& in) { return Step(seq, 0ms, in[0]); }, { motor });
+			s_nStarted = 0;
+			std::exception_ptr error;
+			try {
+				co_await graph.Run(seq);
+			}
+			catch (...) {
+				error = std::current_exception();
+			}
+			nFail += Check(seq, "failed node", error, 1);
+		}
+		co_return int{nFail};
+	}
+
+}
+
+int main() {
+	using namespace gtl::seq;
+	using namespace gtl::seq::test;
+
+	graph_t recipe;
+	BuildRecipe(recipe);
+
+	seq_t driver;
+	auto fRecipe = driver.CreateChildSequence("recipe", 0, std::function<coro_t(seq_t&)>([&recipe](seq_t& seq) { return Recipe(seq, recipe); }));
+	xSleeper sleeper;
+	driver.Run(sleeper);
+
+	auto fErrors = driver.CreateChildSequence("errors", &Errors);
+	driver.Run(sleeper);
+
+	int nFail = fRecipe.get() + fErrors.get();
+	fmt::print("{}\n", nFail ? "FAILED" : "all OK");
+	return nFail ? 1 : 0;
+}
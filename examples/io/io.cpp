@@ -0,0 +1,154 @@
+// io.cpp : i/o awaitables (pipe, loopback socket, file) resumed by the driver. (Linux)
+//
+
+#include <string>
+#include <string_view>
+#include <array>
+#include <cstring>
+
+#include <fmt/core.h>
+#include <fmt/chrono.h>
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#include "gtl/sequence.h"
+#include "gtl/sequence_io.h"
+
+namespace gtl::seq::test {
+
+	using namespace std::literals;
+	namespace chrono = std::chrono;
+
+	using seq_t = gtl::seq::TSequence<std::string>;
+	using coro_t = seq_t::coro_t;
+
+	std::span<std::byte const> AsBytes(std::string_view sv) { return std::as_bytes(std::span(sv)); }
+
+	//=================================================================================
+	// pipe
+
+	coro_t PipeWriter(seq_t& seq, int&& fd) {
+		for (int i = 0; i < 3; i++) {
+			co_await seq.WaitFor(50ms);
+			auto str = fmt::format("message {}", i);
+			auto r = co_await seq.Write(fd, AsBytes(str));
+			fmt::print("{}: written {} bytes\n", seq.GetName(), r);
+		}
+		close(fd);
+		co_return "OK";
+	}
+
+	coro_t PipeReader(seq_t& seq, int&& fd) {
+		std::array<std::byte, 256> buf;
+		while (true) {
+			auto r = co_await seq.Read(fd, buf);	// parked until pipe is readable
+			if (r <= 0)
+				break;
+			fmt::print("{}: read '{}'\n", seq.GetName(), std::string_view((char const*)buf.data(), r));
+		}
+		close(fd);
+		co_return "OK";
+	}
+
+	//=================================================================================
+	// loopback socket
+
+	coro_t EchoServer(seq_t& seq, int&& fdListen) {
+		int fd = (int)co_await seq.Accept(fdListen);
+		close(fdListen);
+		if (fd < 0)
+			co_return fmt::format("accept failed : {}", strerror(-fd));
+
+		std::array<std::byte, 256> buf;
+		while (true) {
+			auto r = co_await seq.Read(fd, buf);
+			if (r <= 0)
+				break;
+			co_await seq.Write(fd, std::span(buf.data(), r));
+		}
+		close(fd);
+		co_return "OK";
+	}
+
+	coro_t EchoClient(seq_t& seq, int&& port) {
+		int fd = socket(AF_INET, SOCK_STREAM|SOCK_CLOEXEC, 0);
+		sockaddr_in addr{};
+		addr.sin_family = AF_INET;
+		addr.sin_port = htons((uint16_t)port);
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		if (auto r = co_await seq.Connect(fd, (sockaddr const*)&addr, sizeof(addr)); r < 0)
+			co_return fmt::format("connect failed : {}", strerror((int)-r));
+
+		std::string result;
+		std::array<std::byte, 256> buf;
+		for (auto str : { "hello"sv, "world"sv }) {
+			co_await seq.Write(fd, AsBytes(str));
+			auto r = co_await seq.Read(fd, buf);
+			if (r <= 0)
+				break;
+			result += std::string_view((char const*)buf.data(), r);
+		}
+		close(fd);
+		co_return result;
+	}
+
+	//=================================================================================
+	// file
+
+	coro_t ReadFile(seq_t& seq, std::string&& path) {
+		int fd = open(path.c_str(), O_RDONLY|O_CLOEXEC);
+		if (fd < 0)
+			co_return "cannot open";
+		std::array<std::byte, 64> buf;
+		auto r = co_await seq.ReadFileAt(fd, buf, 0);
+		close(fd);
+		co_return fmt::format("{} bytes", r);
+	}
+
+}	// namespace gtl::seq::test
+
+int main() {
+	using namespace gtl::seq::test;
+
+	try {
+		seq_t driver;
+		gtl::seq::xIOContext io;	// i/o context of this (driver) thread
+
+		// pipe
+		int fds[2]{};
+		if (pipe2(fds, O_CLOEXEC) < 0)
+			return -1;
+		auto fReader = driver.CreateChildSequence<int>("PipeReader", &PipeReader, std::move(fds[0]));
+		auto fWriter = driver.CreateChildSequence<int>("PipeWriter", &PipeWriter, std::move(fds[1]));
+
+		// loopback socket
+		int fdListen = socket(AF_INET, SOCK_STREAM|SOCK_CLOEXEC, 0);
+		sockaddr_in addr{};
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		socklen_t len = sizeof(addr);
+		if (bind(fdListen, (sockaddr*)&addr, sizeof(addr)) < 0 or listen(fdListen, 1) < 0 or getsockname(fdListen, (sockaddr*)&addr, &len) < 0)
+			return -1;
+		int port = ntohs(addr.sin_port);
+		auto fServer = driver.CreateChildSequence<int>("EchoServer", &EchoServer, std::move(fdListen));
+		auto fClient = driver.CreateChildSequence<int>("EchoClient", &EchoClient, std::move(port));
+
+		// file
+		std::string path = "/proc/self/status";	// coroutine takes reference. must outlive the sequence.
+		auto fFile = driver.CreateChildSequence<std::string>("ReadFile", &ReadFile, std::move(path));
+
+		// waits for i/o and the next dispatch time together
+		driver.Run(io);
+
+		fmt::print("pipe : {}, {}\n", fReader.get(), fWriter.get());
+		fmt::print("socket : server {}, client received '{}'\n", fServer.get(), fClient.get());
+		fmt::print("file : {}\n", fFile.get());
+	}
+	catch (std::exception& e) {
+		fmt::print("Exception : {}\n", e.what());
+	}
+}
@@ -10,6 +10,8 @@
 
 #include "gtl/sequence.h"
 #include "gtl/sequence_map.h"
+#include "gtl/sequence_future.h"
+#include "gtl/sequence_sleeper.h"
 
 namespace gtl::seq::test {
 
@@ -27,15 +29,8 @@ namespace gtl::seq::test {
 		CApp(seq_t& driver) : seq_map_t("top", driver) {
 		}
 		void Run() {
-			seq_t* driver = GetSequenceDriver();
-			do {
-				gtl::seq::clock_t::time_point t = driver->Dispatch();
-				if (driver->IsDone())
-					break;
-				if (auto ts = t - gtl::seq::clock_t::now(); ts > 3s)
-					t = gtl::seq::clock_t::now() + 3s;
-				std::this_thread::sleep_until(t);
-			} while (true);
+			gtl::seq::xSleeper sleeper;	// wakes up on time, or when woken up by other thread (promise, injection ...)
+			GetSequenceDriver()->Run(sleeper);
 		}
 	};
 
@@ -83,21 +78,20 @@ namespace gtl::seq::test {
 			fmt::print("{}: child done: {}\n", funcname, future.get());
 
 
-			// step - wait for other thread
-			fmt::print("SeqReturningInt : step3 wait...\n");
-			auto i = 10;
-			std::jthread count_down( [&](auto stop) {
-				while (!stop.stop_requested()) {
-					fmt::print("in other thread: count down {}\n", i--);
+			// step - wait for other thread (no polling. the sequence is parked until the promise is set)
+			fmt::print("{}: wait for other thread...\n", funcname);
+			gtl::seq::TAsyncPromise<int> promise;
+			auto result = promise.GetFuture();
+			std::jthread count_down( [&promise] {
+				for (int i = 10; i > 0; i--) {
+					fmt::print("in other thread: count down {}\n", i);
 					std::this_thread::sleep_for(100ms);
 				}
+				promise.SetValue(0);
 			});
 
-			co_await seq.Wait([&, t0 = gtl::seq::clock_t::now()] {	// wait until i == 0
-				return i == 0;
-			}, 1ms);
-
-			count_down.request_stop();
+			auto i = co_await std::move(result);
+			fmt::print("{}: other thread done. {}\n", funcname, i);
 			count_down.join();
 
 
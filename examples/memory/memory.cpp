@@ -0,0 +1,109 @@
+// memory.cpp : memory usage of 1M sleeping sequences. (hot/cold layout of TSequence)
+//
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+#include <fmt/core.h>
+#include <fmt/chrono.h>
+
+#include "gtl/sequence.h"
+
+//-----------------------------------------------------------------------------
+// allocation counter. replaces every form of operator new/delete. (plain, array, nothrow, aligned)
+// header in front of a block : [size][pointer returned by malloc]. any delete can free any new.
+static std::atomic<size_t> s_nAlloc{}, s_nBytes{};
+
+static void* Alloc(size_t size, size_t align = __STDCPP_DEFAULT_NEW_ALIGNMENT__) noexcept {
+	constexpr size_t header = sizeof(void*) * 2;
+	align = std::max(align, sizeof(void*));
+	auto* raw = (char*)std::malloc(size + align + header);
+	if (!raw)
+		return nullptr;
+	auto* p = (char*)(((uintptr_t)raw + header + align - 1) & ~(uintptr_t)(align - 1));
+	((void**)p)[-1] = raw;
+	((size_t*)p)[-2] = size;
+	s_nAlloc++;
+	s_nBytes += size;
+	return p;
+}
+static void* AllocOrThrow(size_t size, size_t align = __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+	if (auto* p = Alloc(size, align))
+		return p;
+	throw std::bad_alloc();
+}
+static void Free(void* p) noexcept {
+	if (!p)
+		return;
+	s_nAlloc--;
+	s_nBytes -= ((size_t*)p)[-2];
+	std::free(((void**)p)[-1]);
+}
+
+void* operator new(size_t size) { return AllocOrThrow(size); }
+void* operator new[](size_t size) { return AllocOrThrow(size); }
+void* operator new(size_t size, std::nothrow_t const&) noexcept { return Alloc(size); }
+void* operator new[](size_t size, std::nothrow_t const&) noexcept { return Alloc(size); }
+void* operator new(size_t size, std::align_val_t align) { return AllocOrThrow(size, (size_t)align); }
+void* operator new[](size_t size, std::align_val_t align) { return AllocOrThrow(size, (size_t)align); }
+void* operator new(size_t size, std::align_val_t align, std::nothrow_t const&) noexcept { return Alloc(size, (size_t)align); }
+void* operator new[](size_t size, std::align_val_t align, std::nothrow_t const&) noexcept { return Alloc(size, (size_t)align); }
+void operator delete(void* p) noexcept { Free(p); }
+void operator delete[](void* p) noexcept { Free(p); }
+void operator delete(void* p, size_t) noexcept { Free(p); }
+void operator delete[](void* p, size_t) noexcept { Free(p); }
+void operator delete(void* p, std::nothrow_t const&) noexcept { Free(p); }
+void operator delete[](void* p, std::nothrow_t const&) noexcept { Free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { Free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { Free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { Free(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { Free(p); }
+void operator delete(void* p, std::align_val_t, std::nothrow_t const&) noexcept { Free(p); }
+void operator delete[](void* p, std::align_val_t, std::nothrow_t const&) noexcept { Free(p); }
+
+namespace gtl::seq::test {
+
+	using namespace std::literals;
+	namespace chrono = std::chrono;
+
+	using seq_t = gtl::seq::TSequence<int>;
+	using coro_t = seq_t::coro_t;
+
+	coro_t Sleep(seq_t& seq) {
+		co_await seq.WaitFor(1h);
+		co_return 0;
+	}
+
+	void Measure(size_t nSequence, bool bName) {
+		seq_t driver;
+		std::vector<std::future<int>> futures;
+		futures.reserve(nSequence);
+
+		auto const nAlloc0 = s_nAlloc.load();
+		auto const nBytes0 = s_nBytes.load();
+		auto t0 = chrono::steady_clock::now();
+		for (size_t i = 0; i < nSequence; i++) {
+			futures.push_back(driver.CreateChildSequence(bName ? fmt::format("sleeping sequence {}", i) : std::string{}, &Sleep));
+		}
+		driver.Dispatch();	// all sequences are sleeping now.
+		auto t1 = chrono::steady_clock::now();
+
+		auto const nAlloc = s_nAlloc.load() - nAlloc0;
+		auto const nBytes = s_nBytes.load() - nBytes0 - nSequence * sizeof(std::future<int>);
+		fmt::print("{} sleeping sequences{} : {} allocations, {} MB. {:.1f} bytes/sequence. ({} to create and dispatch)\n",
+			nSequence, bName ? " (named)" : "", nAlloc, nBytes >> 20, (double)nBytes / nSequence,
+			chrono::duration_cast<chrono::milliseconds>(t1 - t0));
+	}
+
+}
+
+int main() {
+	using namespace gtl::seq::test;
+	fmt::print("sizeof(TSequence) : {} bytes (scheduler state, hot)\n", sizeof(seq_t));
+	Measure(1'000'000, false);
+	Measure(1'000'000, true);
+}
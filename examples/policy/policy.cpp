@@ -0,0 +1,102 @@
+// policy.cpp : per-tick dispatch cost of multi-thread / single-thread policies, and of sequences having mixed return types
+//
+
+#include <string>
+
+#include <fmt/core.h>
+#include <fmt/chrono.h>
+
+#include "gtl/sequence.h"
+#include "gtl/sequence_tReturn.h"
+
+namespace gtl::seq::test {
+
+	using namespace std::literals;
+	namespace chrono = std::chrono;
+
+	constexpr size_t nParent = 10;
+	constexpr size_t nLeaf = 100;	// per parent
+	constexpr size_t nTick = 2'000;
+
+	/// @brief tree of sequences returning the same type
+	template < typename tSequence >
+	struct TTree {
+		using seq_t = tSequence;
+		using coro_t = typename seq_t::coro_t;
+
+		static coro_t Leaf(seq_t& seq) {
+			for (size_t i = 0; i < nTick; i++)
+				co_await seq.WaitFor(1ns);	// next tick
+			co_return {};
+		}
+		static coro_t Parent(seq_t& seq) {
+			for (size_t i = 0; i < nLeaf; i++)
+				seq.CreateChildSequence("leaf", &Leaf);
+			co_await seq.WaitForChild();
+			co_return {};
+		}
+		static void CreateParent(seq_t& driver) { driver.CreateChildSequence("parent", &Parent); }
+	};
+
+	template < typename tTree >
+	struct TBench {
+		using seq_t = typename tTree::seq_t;
+
+		static void Run(char const* name) {
+			seq_t driver;
+			for (size_t i = 0; i < nParent; i++)
+				tTree::CreateParent(driver);
+			driver.Dispatch();	// create leaves
+
+			size_t nDispatch{};
+			auto t0 = chrono::steady_clock::now();
+			while (!driver.IsDone()) {
+				driver.Dispatch();
+				nDispatch++;
+			}
+			auto t1 = chrono::steady_clock::now();
+			auto ns = chrono::duration_cast<chrono::nanoseconds>(t1 - t0).count();
+			fmt::print("{:<32} : {} ticks, {:>8.1f} us/tick, {:>6.1f} ns/resume\n", name, nDispatch,
+				ns / 1e3 / nDispatch, (double)ns / (nParent * nLeaf * nTick));
+		}
+	};
+
+	/// @brief same tree, leaves returning different types. (TSequenceTReturn)
+	struct sTreeTReturn {
+		using seq_t = TSequenceTReturn<>;
+		template < typename tResult >
+		using tcoro_t = seq_t::tcoro_t<tResult>;
+
+		template < typename tResult >
+		static tcoro_t<tResult> Leaf(seq_t& seq) {
+			for (size_t i = 0; i < nTick; i++)
+				co_await seq.WaitFor(1ns);	// next tick
+			co_return tResult{};
+		}
+		static tcoro_t<int> Parent(seq_t& seq) {
+			for (size_t i = 0; i < nLeaf; i++) {
+				switch (i % 3) {
+				case 0: seq.CreateChildSequence("leaf", &Leaf<int>); break;
+				case 1: seq.CreateChildSequence("leaf", &Leaf<double>); break;
+				case 2: seq.CreateChildSequence("leaf", &Leaf<std::string>); break;
+				}
+			}
+			co_await seq.WaitForChild();
+			co_return 0;
+		}
+		static void CreateParent(seq_t& driver) { driver.CreateChildSequence("parent", &Parent); }
+	};
+
+}
+
+int main() {
+	using namespace gtl::seq;
+	using namespace gtl::seq::test;
+	fmt::print("{} sequences ({} parents x {} leaves), {} ticks\n", nParent * nLeaf, nParent, nLeaf, nTick);
+	for (int i = 0; i < 2; i++) {
+		TBench<TTree<TSequence<int, sPolicyMultiThread>>>::Run("multi thread");
+		TBench<TTree<TSequence<int, sPolicySingleThread>>>::Run("single thread");
+		TBench<TTree<TSequence<int, TPolicyNoPredicateWait<sPolicySingleThread>>>>::Run("single thread, no predicate wait");
+		TBench<sTreeTReturn>::Run("tReturn, mixed return types");
+	}
+}
@@ -0,0 +1,82 @@
+// profiler.cpp : suspension point profiler. where a sequence waits, and for how long. (driver.EnableProfiler(), sequence_profiler.h)
+//
+// the sequence waits at three places :
+//	door	: observable whose predicate is already true. (doesn't suspend. must not be charged at all)
+//	reply	: future set by other thread after 200 ms. (no location : unknown)
+//	settle	: WaitFor(50ms), twice.
+// attribution is checked : time waited for the reply is not charged to the door.
+//
+
+#include <chrono>
+#include <functional>
+#include <thread>
+
+#include <fmt/core.h>
+
+#include "gtl/sequence.h"
+#include "gtl/sequence_future.h"
+#include "gtl/sequence_observable.h"
+#include "gtl/sequence_sleeper.h"
+
+namespace gtl::seq::test {
+
+	using namespace std::literals;
+	namespace chrono = std::chrono;
+
+	using seq_t = TSequence<int>;
+	using coro_t = seq_t::coro_t;
+
+	static uint32_t s_lineDoor{}, s_lineSettle{};
+
+	coro_t Transfer(seq_t& seq, TObservable<bool>& doorClosed) {
+		TAsyncPromise<int> promise;
+		auto reply = promise.GetFuture();
+		std::jthread remote([promise = std::move(promise)]() mutable {
+			std::this_thread::sleep_for(200ms);
+			promise.SetValue(1);
+		});
+
+		s_lineDoor = __LINE__ + 1;
+		co_await doorClosed.WaitUntil([](bool closed) { return closed; });
+		co_await std::move(reply);
+		for (int i = 0; i < 2; i++) {
+			s_lineSettle = __LINE__ + 1;
+			co_await seq.WaitFor(50ms);
+		}
+		co_return 0;
+	}
+
+	double Milliseconds(clock_t::duration d) { return chrono::duration<double, std::milli>(d).count(); }
+
+}
+
+int main() {
+	using namespace gtl::seq;
+	using namespace gtl::seq::test;
+
+	TObservable<bool> doorClosed{true};
+
+	seq_t driver("driver");
+	auto& profiler = driver.EnableProfiler();
+	driver.CreateChildSequence("transfer", 0, std::function<coro_t(seq_t&)>([&doorClosed](seq_t& seq) { return Transfer(seq, doorClosed); }));
+	xSleeper sleeper;
+	driver.Run(sleeper);
+
+	fmt::print("{}", profiler.Report());
+
+	double msDoor{}, msSettle{}, msUnknown{};
+	uint64_t nSettle{};
+	for (auto const& site : profiler.GetSites()) {
+		if (!site.sl.line())
+			msUnknown += Milliseconds(site.suspended.sum);
+		else if (site.sl.line() == s_lineDoor)
+			msDoor += Milliseconds(site.suspended.sum);
+		else if (site.sl.line() == s_lineSettle) {
+			msSettle += Milliseconds(site.suspended.sum);
+			nSettle += site.nSuspend;
+		}
+	}
+	bool const bOK = msDoor == 0 and msUnknown >= 190 and nSettle == 2 and msSettle >= 100 and msSettle < 190;
+	fmt::print("door {:.1f} ms, reply (unknown) {:.1f} ms, settle {} x {:.1f} ms : {}\n", msDoor, msUnknown, nSettle, msSettle, bOK ? "OK" : "FAIL");
+	return bOK ? 0 : 1;
+}
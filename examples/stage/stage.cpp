@@ -0,0 +1,101 @@
+// stage.cpp : batched i/o per tick with dispatch stages. (TProcessImage, sequence_stage.h)
+//
+// nStation sequences read their input and write their output every tick over a (simulated) fieldbus.
+// direct : every sequence does its own bus transactions. N reads + N writes per tick.
+// image  : the driver reads all inputs before resuming sequences (pre stage) and writes all outputs after (post stage). 1 read + 1 write per tick.
+//
+
+#include <array>
+#include <chrono>
+#include <functional>
+
+#include <fmt/core.h>
+#include <fmt/chrono.h>
+
+#include "gtl/sequence.h"
+
+namespace gtl::seq::test {
+
+	using namespace std::literals;
+	namespace chrono = std::chrono;
+
+	using seq_t = TSequence<int>;
+	using coro_t = seq_t::coro_t;
+
+	constexpr int nStation = 64;
+	constexpr int nCycle = 1'000;
+
+	//-------------------------------------------------------------------------
+	/// @brief simulated fieldbus. every transaction costs a round trip.
+	class xFieldbus {
+	public:
+		size_t nTransaction{};
+		std::array<int, nStation> registers{};
+
+		int Read(int ch) { RoundTrip(); return registers[ch]; }
+		void Write(int ch, int v) { RoundTrip(); registers[ch] = v; }
+		void ReadAll(std::array<int, nStation>& in) { RoundTrip(); in = registers; }
+		void WriteAll(std::array<int, nStation> const& out) { RoundTrip(); registers = out; }
+
+	protected:
+		void RoundTrip() {
+			nTransaction++;
+			auto t = chrono::steady_clock::now() + 2us;
+			while (chrono::steady_clock::now() < t)
+				;
+		}
+	};
+
+	using image_t = TProcessImage<std::array<int, nStation>, std::array<int, nStation>>;
+
+	coro_t StationDirect(seq_t& seq, xFieldbus& bus, int ch) {
+		for (int i = 0; i < nCycle; i++) {
+			auto v = bus.Read(ch);
+			bus.Write(ch, v + 1);
+			co_await seq.WaitFor(1ns);	// next tick
+		}
+		co_return int{bus.registers[ch]};
+	}
+
+	coro_t StationImage(seq_t& seq, image_t& image, int ch) {
+		for (int i = 0; i < nCycle; i++) {
+			auto v = image.In()[ch];	// no lock, no i/o
+			image.Out()[ch] = v + 1;
+			co_await seq.WaitFor(1ns);	// next tick
+		}
+		co_return int{image.GetOutputs()[ch]};
+	}
+
+	void Measure(char const* title, xFieldbus& bus, seq_t& driver) {
+		auto t0 = chrono::steady_clock::now();
+		size_t nTick{};
+		for (; !driver.IsDone(); nTick++)
+			driver.Dispatch();
+		auto t1 = chrono::steady_clock::now();
+		fmt::print("{:>6} : {} ticks, {:.1f} transactions/tick, {} us/tick, register[0] = {}\n", title, nTick,
+			(double)bus.nTransaction / nTick, chrono::duration_cast<chrono::microseconds>(t1 - t0).count() / nTick, bus.registers[0]);
+	}
+
+}
+
+int main() {
+	using namespace gtl::seq;
+	using namespace gtl::seq::test;
+
+	{
+		xFieldbus bus;
+		seq_t driver("driver");
+		for (int ch = 0; ch < nStation; ch++)
+			driver.CreateChildSequence("station", 0, std::function<coro_t(seq_t&)>([&bus, ch](seq_t& seq) { return StationDirect(seq, bus, ch); }));
+		Measure("direct", bus, driver);
+	}
+	{
+		xFieldbus bus;
+		seq_t driver("driver");
+		image_t image;	// (detached from the driver when destroyed)
+		image.Attach(driver, [&](auto& in) { bus.ReadAll(in); }, [&](auto const& out) { bus.WriteAll(out); });
+		for (int ch = 0; ch < nStation; ch++)
+			driver.CreateChildSequence("station", 0, std::function<coro_t(seq_t&)>([&image, ch](seq_t& seq) { return StationImage(seq, image, ch); }));
+		Measure("image", bus, driver);
+	}
+}
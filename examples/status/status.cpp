@@ -0,0 +1,94 @@
+// status.cpp : status table in shared memory for out-of-process monitoring. (xStatusTable / xStatusTableReader, sequence_status_table.h)
+//
+//	status				: runs a controller exporting its sequences, and samples them as a monitor would.
+//	status --monitor	: samples the table of a running controller. (other process)
+
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include "gtl/sequence.h"
+#include "gtl/sequence_sleeper.h"
+#include "gtl/sequence_status_table.h"
+
+namespace gtl::seq::test {
+
+	using namespace std::literals;
+	namespace chrono = std::chrono;
+
+	using seq_t = TSequence<int>;
+	using coro_t = seq_t::coro_t;
+
+	constexpr char const* s_tableName = "/gtl_seq_status";
+
+	coro_t Axis(seq_t& seq) {
+		for (int i = 0; i < 100; i++)
+			co_await seq.WaitFor(10ms);
+		co_return 0;
+	}
+	coro_t Cell(seq_t& seq) {
+		seq.CreateChildSequence("axis.x", &Axis);
+		seq.CreateChildSequence("axis.y", &Axis);
+		co_await seq.WaitForChild();
+		co_return 0;
+	}
+
+	void Print(xStatusTableReader const& reader) {
+		std::vector<sStatusRecord> records;
+		auto summary = reader.Sample(records);
+		if (!summary) {
+			fmt::print("no consistent sample. (exporter stopped while writing)\n");
+			return;
+		}
+		fmt::print("pid {} generation {} : {} sequences (build {} ns)\n", summary->pid, summary->generation, summary->nSlot, summary->durBuild);
+		for (auto const& r : records) {
+			auto due = r.tNextDispatch == INT64_MAX ? -1 : (r.tNextDispatch - summary->tExported) / 1'000'000;
+			fmt::print("  {:{}}{:<12} state {} resume {:4} due {} ms\n", "", r.depth * 2, r.GetName(), (int)r.state, r.nResume, due);
+		}
+	}
+
+	int Monitor() {
+		xStatusTableReader reader(s_tableName);
+		for (uint64_t generation{}; ; std::this_thread::sleep_for(1s)) {
+			auto summary = reader.GetSummary();
+			if (!summary or summary->generation == generation)
+				break;	// controller stopped
+			generation = summary->generation;
+			Print(reader);
+		}
+		return 0;
+	}
+
+}
+
+int main(int argc, char* argv[]) {
+	using namespace gtl::seq;
+	using namespace gtl::seq::test;
+
+	if (argc > 1 and std::string_view(argv[1]) == "--monitor")
+		return Monitor();
+
+	xStatusTable table(s_tableName, 1024);
+
+	seq_t driver("controller");
+	driver.SetSnapshotHandler([&table](sSequenceSnapshot const& snapshot) { table.Export(snapshot); });
+	driver.EnableSnapshot(50ms);
+	driver.CreateChildSequence("cell1", &Cell);
+	driver.CreateChildSequence("cell2", &Cell);
+
+	// monitor. (normally other process : status --monitor)
+	std::jthread monitor([](std::stop_token stop) {
+		xStatusTableReader reader(s_tableName);
+		while (!stop.stop_requested()) {
+			std::this_thread::sleep_for(300ms);
+			Print(reader);
+		}
+	});
+
+	xSleeper sleeper;
+	driver.Run(sleeper);
+	driver.PublishSnapshot();
+	Print(xStatusTableReader(s_tableName));
+}
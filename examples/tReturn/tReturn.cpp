@@ -8,6 +8,7 @@
 #include <fmt/xchar.h>
 #include <fmt/chrono.h>
 #include "gtl/sequence.h"
+#include "gtl/sequence_future.h"
 #include "gtl/sequence_tReturn.h"
 #include "gtl/sequence_map.h"
 
@@ -47,18 +48,17 @@ namespace gtl::seq::test {
 
 		// step 3
 		fmt::print("SeqReturningInt : step3 wait...\n");
-		auto i = 10;
-		std::jthread count_down( [&](auto stop) {
-			while (!stop.stop_requested()) {
-				fmt::print("SeqReturningInt : step3 count down {}\n", i--);
+		gtl::seq::TAsyncPromise<int> promise;
+		auto counted = promise.GetFuture();
+		std::jthread count_down( [&promise] {
+			for (int i = 10; i > 0; i--) {
+				fmt::print("SeqReturningInt : step3 count down {}\n", i);
 				std::this_thread::sleep_for(100ms);
 			}
+			promise.SetValue(0);
 		});
 
-		co_await seq.Wait([&, t0 = gtl::seq::clock_t::now()] {	// wait until i == 0
-			return i == 0;
-		}, 1ms);
-		count_down.request_stop();
+		co_await std::move(counted);	// parked until the count down thread sets the promise. (no polling)
 		count_down.join();
 
 		// step 4
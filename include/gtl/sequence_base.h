@@ -0,0 +1,1346 @@
+#pragma once
+
+//////////////////////////////////////////////////////////////////////
+//
+// sequence_base.h: scheduler core shared by TSequence and TSequenceTReturn
+//
+// PWH
+// 2026-10-18. moved from sequence.h
+//
+//////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <atomic>
+#include <coroutine>
+#include <future>
+#include <list>
+#include <functional>
+#include <optional>
+#include <chrono>
+#include <ranges>
+#include <mutex>
+#include <thread>
+#include <exception>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "sequence_coroutine_handle.h"
+#include "sequence_generator.h"
+#include "sequence_policy.h"
+#include "sequence_wake.h"
+#include "sequence_pool.h"
+#include "sequence_snapshot.h"
+#include "sequence_ready.h"
+#include "sequence_stage.h"
+#include "sequence_profiler.h"
+#if defined(__linux__)
+#	include "sequence_io.h"
+#endif
+
+namespace gtl::seq::inline v01 {
+
+	//-------------------------------------------------------------------------
+	/// @brief typed key of sequence-local context. (address of key is unique per type)
+	template < typename T >
+	struct TContextKey {
+		inline static char const key{};
+	};
+	/// @brief sequence-local context slot. slots set on a sequence shadow the inherited ones.
+	struct sContextNode {
+		void const* key{};
+		std::shared_ptr<void> value;
+		std::shared_ptr<sContextNode const> next;	// inherited (or set before)
+	};
+
+	template < typename tSequence > class TTaskGraph;
+
+	//-------------------------------------------------------------------------
+	/// @brief results of child sequences created at once. (CreateChildSequences())
+	/// the creating sequence waits for them as a group with co_await seq.WaitForChild(). (a parent is resumed after its children are done)
+	template < typename tResult >
+	class TBatch {
+	public:
+		using result_t = tResult;
+		using future_t = std::future<tResult>;
+
+	protected:
+		std::vector<future_t> m_futures;
+
+	public:
+		TBatch() = default;
+		explicit TBatch(std::vector<future_t> futures) : m_futures(std::move(futures)) {}
+		TBatch(TBatch&&) = default;
+		TBatch& operator = (TBatch&&) = default;
+
+		size_t size() const { return m_futures.size(); }
+		bool empty() const { return m_futures.empty(); }
+		future_t& operator [] (size_t index) { return m_futures[index]; }
+		auto begin() { return m_futures.begin(); }
+		auto end() { return m_futures.end(); }
+
+		/// @brief true if all child sequences are done. (non-blocking)
+		bool IsReady() const {
+			return std::ranges::all_of(m_futures, [](auto const& f) { return !f.valid() or f.wait_for(std::chrono::seconds{}) == std::future_status::ready; });
+		}
+		/// @brief results in creation order. blocks if not ready. (rethrows the first exception)
+		auto GetAll() requires (!std::is_void_v<tResult>) {
+			std::vector<tResult> results;
+			results.reserve(m_futures.size());
+			for (auto& f : m_futures)
+				results.push_back(f.get());
+			return results;
+		}
+	};
+
+	//-------------------------------------------------------------------------
+	/// @brief scheduler core of sequences. (TSequence, TSequenceTReturn)
+	/// tSelf : derived sequence class (CRTP). it only adds typed CreateChildSequence() overloads.
+	/// the coroutine is held as a type-erased std::coroutine_handle<>. the result flows through the promise in the coroutine frame,
+	/// and an escaped exception through sUnhandledException. so dispatching is the same (non-virtual) for every result type.
+	/// layout : scheduler-hot fields (parent, handle, next dispatch time, ...) are kept in the object itself. (<= 64 bytes)
+	/// cold data (name, children, mutex, slack, predicate, wake-up node) are allocated on first use. so is the state of the driver. (ready heap, wake queue, ...)
+	/// a leaf sequence without name and Wait(pred) never allocates them.
+	/// scheduling : the driver (top most sequence) keeps every sequence which can be resumed by time in a ready heap. (sequence_ready.h)
+	/// Dispatch() pops due sequences, and resumes a parent when its last child is done. nothing walks the tree recursively,
+	/// so the cost of a tick does not depend on the depth of the tree, and deep trees (ex, recursive retry) don't overflow the stack.
+	/// tPolicy : threading model, predicate wait, clock, allocator. (sequence_policy.h)
+	template < typename tSelf, typename tPolicy = sPolicyMultiThread >
+	class TSequenceBase {
+	public:
+		using this_t = TSequenceBase;
+		using self_t = tSelf;
+		using policy_t = tPolicy;
+		using mutex_t = typename tPolicy::mutex_t;
+		using thread_id_t = typename tPolicy::thread_id_t;
+
+	protected:
+		using children_t = std::list<tSelf, typename tPolicy::template allocator_t<tSelf>>;
+		using ready_t = TReadyHeap<tSelf>;
+		friend class TReadyHeap<tSelf>;
+
+		/// @brief predicate of Wait(pred). evaluated by the driver before resuming the sequence
+		struct sPredicate {
+			std::function<bool()> func;
+			clock_t::time_point t0;
+			clock_t::duration interval, timeout, slack;
+			std::promise<bool> result;
+		};
+
+		/// @brief state of the driver (top most sequence) only. allocated on first use, so other sequences pay one pointer (in sCold) for it
+		struct sDriver {
+			ready_t ready;	// ready heap
+			typename tPolicy::template atomic_t<xWakeQueue*> wakeQueue{};	// sequences woken up from other threads. (and notifier of the driver loop) closed, not deleted : wake nodes share it
+			typename tPolicy::template atomic_t<xSnapshotBoard*> snapshot{};	// published tree snapshots
+			xDispatchStages* stages{};	// pre/post dispatch stages. (driver thread)
+			xSuspendProfiler* profiler{};	// (driver thread)
+
+			sDriver() = default;
+			sDriver(sDriver const&) = delete;
+			sDriver& operator = (sDriver const&) = delete;
+			~sDriver() {
+				if (auto* queue = AtomicLoad(wakeQueue))
+					queue->Close();	// wake nodes still alive refer to it
+				PolicyDelete<tPolicy>(AtomicLoad(snapshot));
+				PolicyDelete<tPolicy>(stages);
+				PolicyDelete<tPolicy>(profiler);
+			}
+		};
+
+		/// @brief cold data. allocated on first use
+		struct sCold {
+			seq_id_t name;
+			children_t children;	// changed only on the driver thread, under mtxChildren. (other threads read it under the lock. FindDirectChild())
+			mutable mutex_t mtxChildren;
+			clock_t::duration slack{};	// default timer slack of WaitFor/WaitUntil/Wait. inherited by child sequences
+			std::unique_ptr<sPredicate> pred;	// Wait(pred)
+			std::shared_ptr<sWakeNode> wake;	// created on first use, under mtxChildren
+			std::shared_ptr<sWakeNode> wakeHandle;	// GetWakeHandle(). created on first use
+			std::shared_ptr<sContextNode const> context;	// sequence-local context. (shared with parent)
+			uint64_t nResume{};	// statistics (snapshot)
+			bool bKeepException{};	// escaped exception goes to the future only. not rethrown by Dispatch(). (ForEach)
+			bool bSweep{};	// in the driver's list of parents having finished children
+			bool bWaitWake{};	// parked at WaitWake()
+			bool bParked{};	// parked on the wake node. (futures, channels, pool ...) cleared whenever the sequence is resumed
+			uint32_t nWakeParked{};	// wake->nWake when parked. wake-ups counted before belong to earlier parks
+			typename tPolicy::template atomic_t<bool> bWakePublished{};	// set after wake is created. (lock-free read on the driver thread)
+			typename tPolicy::template atomic_t<sDriver*> driver{};	// top most only. allocated on first use
+			~sCold() {
+				// descendants are moved up to this list, then destroyed one by one. (no recursion. parents first)
+				for (auto iter = children.begin(); iter != children.end(); iter++) {
+					if (auto* cold = iter->GetCold()) {
+						std::scoped_lock<mutex_t> lock{cold->mtxChildren};
+						children.splice(children.end(), cold->children);
+					}
+				}
+				children.clear();
+				PolicyDelete<tPolicy>(AtomicLoad(driver));
+			}
+		};
+
+		// hot
+		tSelf* m_parent{};
+		std::coroutine_handle<> m_handle;
+		clock_t::time_point m_tNextDispatch{};	// earliest time to resume
+		clock_t::time_point m_tNextDispatchLatest{};	// m_tNextDispatch + slack. the driver wakes up at the earliest of these. (timer coalescing)
+		[[no_unique_address]] thread_id_t m_threadID{tPolicy::GetThreadID()};	// NOT const. may be created from other thread (injection)
+		mutable typename tPolicy::template atomic_t<sCold*> m_cold{};
+		ready_t* m_ready{};	// driver's ready heap. (set when linked to the tree)
+		uint32_t m_iReady{ready_t::npos};	// position in the ready heap
+		inline thread_local static tSelf* s_seqCurrent{};
+
+		template < typename tSequence > friend class TTaskGraph;
+		template < typename tResult, typename tParam, typename tPolicy2 > friend class TSequenceMap;
+
+		inline static seq_id_t const s_nameEmpty;
+
+	protected:
+		// constructor
+		explicit TSequenceBase(seq_id_t name = "") : m_handle(nullptr) {
+			if (!name.empty())
+				Cold().name = std::move(name);
+		}
+		TSequenceBase(TSequenceBase const&) = delete;
+		TSequenceBase& operator = (TSequenceBase const&) = delete;
+		TSequenceBase(TSequenceBase&& b) : m_handle(nullptr) {
+			m_handle = std::exchange(b.m_handle, nullptr);
+			m_tNextDispatch = std::exchange(b.m_tNextDispatch, {});
+			m_tNextDispatchLatest = std::exchange(b.m_tNextDispatchLatest, {});
+			m_cold = AtomicExchange(b.m_cold, (sCold*)nullptr);
+			m_ready = b.m_ready;
+			m_iReady = std::exchange(b.m_iReady, ready_t::npos);
+			if (m_ready)
+				m_ready->Relocate(Self());
+			if (auto* cold = GetCold()) {
+				for (auto* wake : { cold->wake.get(), cold->wakeHandle.get() })
+					if (wake)
+						wake->seq = this;
+			}
+		}
+		TSequenceBase& operator = (TSequenceBase&& b) {
+			Destroy();
+			PolicyDelete<tPolicy>(AtomicExchange(m_cold, (sCold*)nullptr));
+			m_handle = std::exchange(b.m_handle, nullptr);
+			m_tNextDispatch = std::exchange(b.m_tNextDispatch, {});
+			m_tNextDispatchLatest = std::exchange(b.m_tNextDispatchLatest, {});
+			m_cold = AtomicExchange(b.m_cold, (sCold*)nullptr);
+			m_ready = b.m_ready;
+			m_iReady = std::exchange(b.m_iReady, ready_t::npos);
+			if (m_ready)
+				m_ready->Relocate(Self());
+			if (auto* cold = GetCold()) {
+				for (auto* wake : { cold->wake.get(), cold->wakeHandle.get() })
+					if (wake)
+						wake->seq = this;
+			}
+			return *this;
+		}
+
+		// destructor
+		~TSequenceBase() {
+			Destroy();
+			PolicyDelete<tPolicy>(AtomicExchange(m_cold, (sCold*)nullptr));	// children
+		}
+
+	public:
+		void SetName(seq_id_t name) {
+			if (!name.empty() or GetCold())
+				Cold().name = std::move(name);
+		}
+		auto const& GetName() const {
+			if (auto* cold = GetCold())
+				return cold->name;
+			return s_nameEmpty;
+		}
+
+		inline void Destroy() {
+			if (auto* cold = GetCold()) {
+				cold->name.clear();
+				std::shared_ptr<sWakeNode> wake;
+				if (AtomicLoad(cold->bWakePublished)) {
+					std::scoped_lock<mutex_t> lock{cold->mtxChildren};	// other threads read it under the lock
+					AtomicStore(cold->bWakePublished, false);
+					wake = std::exchange(cold->wake, nullptr);
+				}
+				if (wake)
+					wake->seq = nullptr;
+				if (auto wake = std::exchange(cold->wakeHandle, nullptr))
+					wake->seq = nullptr;
+			}
+			if (m_iReady != ready_t::npos)
+				m_ready->Remove(Self());
+			xSuspendProfiler::Forget(this);
+			if (auto h = std::exchange(m_handle, nullptr); h) {
+				h.destroy();
+			}
+		}
+
+		/// @brief 
+		/// @return 
+		inline bool IsDone() const {
+			if (HasChild() or (m_handle and !m_handle.done()))
+				return false;
+			if (!m_parent) {
+				// driver : children created from other threads are linked at the next Dispatch()
+				if (auto* queue = GetWakeQueue(); queue and !queue->Empty())
+					return false;
+			}
+			return true;
+		}
+
+		/// @brief 
+		/// @return true if it has child sequence
+		inline bool HasChild() const {
+			auto const* cold = GetCold();
+			return cold and !cold->children.empty();
+		}
+
+		/// @brief mutex for children. (locked when accessed from other thread)
+		mutex_t& GetChildrenMutex() const { return Cold().mtxChildren; }
+
+		/// @brief 
+		/// @return current running sequence
+		static tSelf* GetCurrentSequence() { return s_seqCurrent; }
+
+		/// @brief 
+		/// @return working thread id
+		auto GetWorkingThreadID() const { return m_threadID; }
+
+		/// @brief set driver wake-up function. called (from any thread) when a sequence is injected or rescheduled from other thread.
+		/// can be replaced while other threads notify. returns after running notifications are done.
+		/// @return previous notifier
+		std::function<void()> SetNotifier(std::function<void()> fnNotify) { return WakeQueue().SetNotifier(std::move(fnNotify)); }
+
+		/// @brief driver (top most sequence) of this tree
+		tSelf& GetDriver() {
+			auto* top = this;
+			while (top->m_parent)
+				top = top->m_parent;
+			return top->Self();
+		}
+
+		/// @brief wakes up driver loop (calls notifier of the top most sequence). can be called from any thread.
+		void NotifyDriver() const {
+			auto const* top = this;
+			while (top->m_parent)
+				top = top->m_parent;
+			if (auto* queue = top->GetWakeQueue())
+				queue->Notify();
+		}
+
+		/// @brief posts a task to the driver. the task runs on the driver thread at the beginning of next Dispatch(). can be called from any thread.
+		void Post(std::function<void()> task) {
+			auto* top = this;
+			while (top->m_parent)
+				top = top->m_parent;
+			auto& queue = top->WakeQueue();
+			queue.Post(std::move(task));
+			queue.Notify();
+		}
+
+		/// @brief wake-up node to resume this sequence from other threads.
+		/// created once on first use. (ReserveResume() and child creation from other threads use it too)
+		/// other threads (and the first call) read it under the lock. the driver thread reads it lock-free once it is published.
+		std::shared_ptr<sWakeNode> const& GetWakeNode() {
+			auto& cold = Cold();
+			auto& wake = cold.wake;
+			if (AtomicLoad(cold.bWakePublished) and !tPolicy::IsOtherThread(m_threadID)) [[likely]]
+				return wake;
+			std::scoped_lock<mutex_t> lock{cold.mtxChildren};
+			if (!wake) {
+				auto* top = this;
+				while (top->m_parent)
+					top = top->m_parent;
+				wake = std::make_shared<sWakeNode>();
+				wake->queue = top->WakeQueue().shared_from_this();
+				wake->seq = this;
+				wake->fnResume = [](void* seq) {
+					// stale wake-up (the sequence has been resumed otherwise since it parked. ex, by its finished children) : ignored
+					// so is a node queued for an earlier park, and drained after the sequence parked again.
+					auto* cold = ((this_t*)seq)->GetCold();
+					if (!cold or !cold->bParked or cold->wake->nWake.load(std::memory_order_acquire) == cold->nWakeParked)
+						return;
+					cold->bParked = false;
+					((this_t*)seq)->ReserveResume();
+				};
+				AtomicStore(cold.bWakePublished, true);
+			}
+			return wake;
+		}
+		/// @brief wake node for an awaiter about to park this sequence. (await_suspend, driver thread)
+		/// the node resumes the sequence only while it is parked. a late wake-up can't cut short what the sequence waits for next.
+		std::shared_ptr<sWakeNode> const& ParkOnWakeNode() {
+			auto const& wake = GetWakeNode();
+			auto& cold = Cold();
+			cold.bParked = true;
+			cold.nWakeParked = wake->nWake.load(std::memory_order_acquire);
+			return wake;
+		}
+
+		/// @brief handle to wake up this sequence from any thread (ex, interrupt handler). the sequence waits for it with co_await seq.WaitWake().
+		/// call on the driver thread. (inside the sequence) all copies share one node.
+		xWakeHandle GetWakeHandle() {
+			auto& wake = Cold().wakeHandle;
+			if (!wake) {
+				auto* top = this;
+				while (top->m_parent)
+					top = top->m_parent;
+				wake = std::make_shared<sWakeNode>();
+				wake->queue = top->WakeQueue().shared_from_this();
+				wake->seq = this;
+				wake->fnResume = [](void* seq) {
+					// woken up while not waiting : the flag is consumed by the next WaitWake()
+					if (auto* cold = ((this_t*)seq)->GetCold(); cold and cold->bWaitWake)
+						((this_t*)seq)->ReserveResume();
+				};
+			}
+			return xWakeHandle(wake);
+		}
+
+		/// @brief 
+		/// @return Get Next Dispatch Time. (earliest of its descendants, if it has children)
+		clock_t::time_point GetNextDispatchTime() const {
+			if (!HasChild())
+				return (m_handle and !m_handle.done()) ? m_tNextDispatch : clock_t::time_point::max();
+			if (auto* queue = GetWakeQueue(); queue and !queue->Empty())
+				return {};	// driver. posted tasks, injected children, woken up sequences
+			if (auto* ready = GetReadyHeap())	// driver. all sequences of the tree are in the ready heap
+				return ready->finished.empty() ? ready->NextDispatch() : clock_t::time_point{};
+			auto t = clock_t::time_point::max();
+			ForEachDescendant([&t](tSelf const& seq) {
+				if (!seq.HasChild())
+					t = std::min(t, seq.GetNextDispatchTime());
+			});
+			return t;
+		}
+
+		/// @brief 
+		/// @return latest time to be dispatched (next dispatch time + slack). used for coalescing wake-ups
+		clock_t::time_point GetNextDispatchTimeLatest() const {
+			if (!HasChild())
+				return (m_handle and !m_handle.done()) ? m_tNextDispatchLatest : clock_t::time_point::max();
+			if (auto* queue = GetWakeQueue(); queue and !queue->Empty())
+				return {};
+			if (auto* ready = GetReadyHeap())
+				return ready->finished.empty() ? ready->NextDispatchLatest() : clock_t::time_point{};
+			auto t = clock_t::time_point::max();
+			ForEachDescendant([&t](tSelf const& seq) {
+				if (!seq.HasChild())
+					t = std::min(t, seq.GetNextDispatchTimeLatest());
+			});
+			return t;
+		}
+
+		/// @brief reserves next dispatch time. NOT dispatch, NOT reserve dispatch itself.
+		/// @param slack : dispatch may be delayed up to (tWhen + slack) to be batched with other sequences
+		/// from other threads, the reservation is posted to the driver. (the ready heap belongs to the driver thread)
+		/// the posted task reaches the sequence through its wake node, so it does nothing if the sequence is destroyed before the driver runs it.
+		bool ReserveResume(clock_t::time_point tWhen = {}, clock_t::duration slack = {}) {
+			if (!m_handle or m_handle.done())
+				return false;
+			auto const tLatest = AddSlack(tWhen, slack);
+			if (tPolicy::IsOtherThread(m_threadID)) [[unlikely]] {
+				auto const& wake = GetWakeNode();
+				wake->queue->Post([wake, tWhen, tLatest] {
+					if (auto* seq = (this_t*)wake->seq)
+						seq->SetNextDispatchTime(tWhen, tLatest);
+				});
+				wake->queue->Notify();
+				return true;
+			}
+			SetNextDispatchTime(tWhen, tLatest);
+			return true;
+		}
+		bool ReserveResume(clock_t::duration dur, clock_t::duration slack = {}) { return ReserveResume(dur.count() ? tPolicy::Now() + dur : clock_t::time_point{}, slack); }
+
+		/// @brief sequence-local context. child sequences created afterwards inherit it. (typed slot, no name lookup)
+		template < typename T >
+		void SetContext(std::shared_ptr<T> value) {
+			auto& cold = Cold();
+			cold.context = std::make_shared<sContextNode const>(sContextNode{ .key = &TContextKey<T>::key, .value = std::move(value), .next = std::move(cold.context) });
+		}
+		template < typename T, typename ... tArgs >
+		T& EmplaceContext(tArgs&& ... args) {
+			auto value = std::make_shared<T>(std::forward<tArgs>(args)...);
+			auto& r = *value;
+			SetContext<T>(std::move(value));
+			return r;
+		}
+		/// @return context of type T set on this sequence or inherited from parents. nullptr if none
+		template < typename T >
+		T* GetContext() const {
+			auto const* cold = GetCold();
+			for (auto const* node = cold ? cold->context.get() : nullptr; node; node = node->next.get()) {
+				if (node->key == &TContextKey<T>::key)
+					return static_cast<T*>(node->value.get());
+			}
+			return nullptr;
+		}
+
+		/// @brief default timer slack for WaitFor/WaitUntil/Wait. child sequences created afterwards inherit it.
+		void SetDefaultSlack(clock_t::duration slack) {
+			if (slack.count() or GetCold())
+				Cold().slack = slack;
+		}
+		clock_t::duration GetDefaultSlack() const {
+			auto const* cold = GetCold();
+			return cold ? cold->slack : clock_t::duration{};
+		}
+
+		/// @brief 
+		/// @return direct child sequence count
+		size_t CountChild() const {
+			auto const* cold = GetCold();
+			return cold ? cold->children.size() : 0;
+		}
+
+		/// @brief creates child sequence streaming values with co_yield. (sequence_generator.h)
+		/// @param func coroutine function returning TGenerator<T>
+		/// @param ...args for coroutine function. must be moved or copied.
+		/// @return consumer side. consume it from a sequence other than this (parent is not resumed while it has children), or from other threads.
+		template < typename T, typename ... tArgs >
+		TStream<T> CreateGenerator(seq_id_t name, std::function<TGenerator<T>(tSelf&, tArgs&& ...)> func, tArgs&&... args) {
+			return CreateChildSequenceT<TGenerator<T>, tArgs...>(std::move(name), 0, std::move(func), std::forward<tArgs>(args)...);
+		}
+		template < typename T, typename ... tArgs >
+		TStream<T> CreateGenerator(seq_id_t name, TGenerator<T>(*func)(tSelf&, tArgs&& ...), tArgs&&... args) {
+			std::function<TGenerator<T>(tSelf&, tArgs&& ...)> f = func;
+			return CreateGenerator(std::move(name), std::move(f), std::forward<tArgs>(args)...);
+		}
+
+		/// @brief creates child sequences in one operation. (ex, hundreds of children at recipe start-up)
+		/// coroutine frames are created before locking, then all children are linked at once. (one lock, one max_sequence_count check, one schedule update)
+		/// @param name name of all children
+		/// @param params func(seq, param) is called for each param. func returns coroutine. (ex, [](seq_t& seq, int axis) { return Home(seq, axis); })
+		/// @return TBatch. results in the order of params
+		template < std::ranges::input_range tParams, typename tFunc >
+		auto CreateChildSequences(seq_id_t const& name, tParams&& params, tFunc&& func, size_t max_sequence_count = 0) {
+			return CreateChildSequencesT(std::forward<tParams>(params),
+				[&name](auto const&) -> seq_id_t const& { return name; },
+				[&func](tSelf& seq, auto&& param) { return func(seq, std::forward<decltype(param)>(param)); },
+				max_sequence_count);
+		}
+		/// @param specs pairs of (name, param)
+		template < std::ranges::input_range tSpecs, typename tFunc >
+			requires requires (std::ranges::range_reference_t<tSpecs> spec) { { spec.first } -> std::convertible_to<seq_id_t const&>; spec.second; }
+		auto CreateChildSequences(tSpecs&& specs, tFunc&& func) {
+			return CreateChildSequencesT(std::forward<tSpecs>(specs),
+				[](auto const& spec) -> seq_id_t const& { return spec.first; },
+				[&func](tSelf& seq, auto&& spec) {
+					if constexpr (std::is_lvalue_reference_v<decltype(spec)>)
+						return func(seq, spec.second);
+					else
+						return func(seq, std::move(spec.second));
+				},
+				0);
+		}
+
+		/// @brief Find Child Sequence (Direct Child Only)
+		/// @param name 
+		/// @return child sequence. if not found, empty child sequence.
+	#if __cpp_explicit_this_parameter
+		auto FindDirectChild(this auto&& self, seq_id_t const& name) -> decltype(&self) {
+			auto* cold = self.GetCold();
+			if (!cold)
+				return nullptr;
+			std::optional<std::scoped_lock<mutex_t>> lock;
+			if (tPolicy::IsOtherThread(self.m_threadID))
+				lock.emplace(cold->mtxChildren);
+
+			for (auto& child : cold->children) {
+				if (child.GetName() == name)
+					return &child;
+			}
+			return nullptr;
+		}
+	#else
+		tSelf const* FindDirectChild(seq_id_t const& name) const {
+			auto const* cold = GetCold();
+			if (!cold)
+				return nullptr;
+			std::optional<std::scoped_lock<mutex_t>> lock;
+			if (tPolicy::IsOtherThread(m_threadID))
+				lock.emplace(cold->mtxChildren);
+
+			for (auto& child : cold->children) {
+				if (child.GetName() == name)
+					return &child;
+			}
+			return nullptr;
+		}
+		inline tSelf* FindDirectChild(seq_id_t const& name) {
+			return const_cast<tSelf*> ( (const_cast<this_t const*>(this))->FindDirectChild(name) );
+		}
+	#endif
+
+		/// @brief Find Child Sequence (Depth First Search)
+		/// @param name 
+		/// @return child sequence. if not found, empty child sequence.
+	#if __cpp_explicit_this_parameter
+		auto FindChildDFS(this auto&& self, seq_id_t const& name) -> decltype(&self) {
+			// other threads : search the snapshot instead. (GetSnapshot(), EnableSnapshot())
+			if (tPolicy::IsOtherThread(self.m_threadID))
+				return nullptr;
+
+			// direct children first, then children of each child. (explicit stack. no recursion)
+			std::vector<decltype(&self)> stack{ &self };
+			while (!stack.empty()) {
+				auto* seq = stack.back();
+				stack.pop_back();
+				auto* cold = seq->GetCold();
+				if (!cold)
+					continue;
+				for (auto& child : cold->children) {
+					if (child.GetName() == name)
+						return &child;
+				}
+				for (auto& child : cold->children | std::views::reverse)
+					stack.push_back(&child);
+			}
+			return nullptr;
+		}
+	#else
+		tSelf const* FindChildDFS(seq_id_t const& name) const {
+			// other threads : search the snapshot instead. (GetSnapshot(), EnableSnapshot())
+			if (tPolicy::IsOtherThread(m_threadID))
+				return nullptr;
+
+			// direct children first, then children of each child. (explicit stack. no recursion)
+			std::vector<this_t const*> stack{ this };
+			while (!stack.empty()) {
+				auto const* seq = stack.back();
+				stack.pop_back();
+				auto const* cold = seq->GetCold();
+				if (!cold)
+					continue;
+				for (auto const& child : cold->children) {
+					if (child.GetName() == name)
+						return &child;
+				}
+				for (auto const& child : cold->children | std::views::reverse)
+					stack.push_back(&child);
+			}
+			return nullptr;
+		}
+		inline tSelf* FindChildDFS(seq_id_t const& name) {
+			return const_cast<tSelf*>( (const_cast<this_t const*>(this))->FindChildDFS(name) );
+		}
+	#endif
+
+		/// @brief registers a function run once per Dispatch() on the driver thread. (call on the driver thread)
+		/// pre : before any sequence is resumed. (ex, reads all inputs into a process image. TProcessImage, sequence_stage.h)
+		/// post : after all due sequences are resumed. (ex, writes all outputs in one batch)
+		/// @return id for RemoveDispatchStage()
+		uint64_t AddDispatchStage(eDispatchStage stage, std::function<void()> func) {
+			auto* top = this;
+			while (top->m_parent)
+				top = top->m_parent;
+			auto& driver = top->DriverState();
+			if (!driver.stages)
+				driver.stages = PolicyNew<tPolicy, xDispatchStages>();
+			return driver.stages->Add(stage, std::move(func));
+		}
+		bool RemoveDispatchStage(uint64_t id) {
+			auto* top = this;
+			while (top->m_parent)
+				top = top->m_parent;
+			auto* stages = top->GetDispatchStages();
+			return stages and stages->Remove(id);
+		}
+
+		/// @brief enables suspension point profiler. (sequence_profiler.h, call on the driver thread)
+		/// aggregates per co_await location : suspensions, time suspended, cpu time of the following slice. driver.GetProfiler()->Report()
+		xSuspendProfiler& EnableProfiler(bool bEnable = true) {
+			auto* top = this;
+			while (top->m_parent)
+				top = top->m_parent;
+			auto& driver = top->DriverState();
+			if (!driver.profiler)
+				driver.profiler = PolicyNew<tPolicy, xSuspendProfiler>();
+			driver.profiler->Enable(bEnable);
+			return *driver.profiler;
+		}
+		xSuspendProfiler* GetProfiler() const {
+			auto* driver = GetDriverState();
+			return driver ? driver->profiler : nullptr;
+		}
+
+		/// @brief enables tree snapshots for monitoring threads. (call on the driver thread, before readers start)
+		/// the driver publishes a snapshot at the end of Dispatch() every interval. (0 : every tick, max : on demand only, PublishSnapshot())
+		void EnableSnapshot(clock_t::duration interval = {}) { SnapshotBoard().SetInterval(interval); }
+		/// @brief handler called on the driver thread with every published snapshot. (ex, xStatusTable::Export. sequence_status_table.h)
+		void SetSnapshotHandler(std::function<void(sSequenceSnapshot const&)> handler) { SnapshotBoard().fnPublished = std::move(handler); }
+		/// @brief builds and publishes snapshot of this tree now. (driver thread)
+		std::shared_ptr<sSequenceSnapshot const> PublishSnapshot() {
+			auto& board = SnapshotBoard();
+			auto const t0 = tPolicy::Now();
+			auto snapshot = board.Prepare();
+			snapshot->tTaken = t0;
+			FillSnapshot(*snapshot, t0);
+			snapshot->durBuild = tPolicy::Now() - t0;
+			board.Publish(snapshot, t0);
+			return snapshot;
+		}
+		/// @brief latest published snapshot of the whole tree. can be called from any thread. never blocks the driver.
+		/// @return nullptr if no snapshot is published yet
+		std::shared_ptr<sSequenceSnapshot const> GetSnapshot() const {
+			auto const* top = this;
+			while (top->m_parent)
+				top = top->m_parent;
+			auto* driver = top->GetDriverState();
+			auto* board = driver ? AtomicLoad(driver->snapshot) : nullptr;
+			return board ? board->Get() : nullptr;
+		}
+
+		/// @brief main dispatch function. (call on the driver, the top most sequence)
+		/// @return next dispatch time. (coalesced : earliest of (next dispatch time + slack) of all sequences)
+		clock_t::time_point Dispatch() {
+			if (tPolicy::IsOtherThread(m_threadID)) [[ unlikely ]] {
+				throw xException("Dispatch() must be called from the same thread as the driver");
+				return {};
+			}
+			if (m_parent) [[ unlikely ]] {
+				throw xException("Dispatch() must be called on the driver (top most sequence)");
+				return {};
+			}
+			if (s_seqCurrent) [[ unlikely ]] {
+				throw xException("Dispatch() must NOT be called from Dispatch. !!! No ReEntrance");
+				return {};
+			}
+			auto* profiler = GetProfiler();
+			xSuspendProfiler::sScope profiling(profiler and profiler->IsEnabled() ? profiler : nullptr);
+			auto* stages = GetDispatchStages();
+			if (stages) [[unlikely]]
+				stages->Run(eDispatchStage::pre);
+			if (auto* queue = GetWakeQueue(); queue and !queue->Empty())
+				queue->Drain();	// tasks posted and sequences woken up from other threads
+			auto* ready = GetReadyHeap();
+			if (ready and stages) [[unlikely]] {
+				try {
+					DispatchReady(*ready);
+				} catch (...) {
+					stages->Run(eDispatchStage::post);	// outputs of sequences resumed before the exception
+					throw;
+				}
+			}
+			else if (ready)
+				DispatchReady(*ready);
+			if (stages) [[unlikely]]
+				stages->Run(eDispatchStage::post);
+			if (auto* driver = GetDriverState(); driver and AtomicLoad(driver->snapshot)) [[unlikely]] {
+				if (AtomicLoad(driver->snapshot)->IsDue(tPolicy::Now()))
+					PublishSnapshot();
+			}
+			if (!ready or IsDone())
+				return clock_t::time_point::max();
+			return ready->NextDispatchLatest();
+		}
+
+		/// @brief dispatch loop. dispatches until all sequences are done, sleeping between dispatches.
+		/// @param sleeper xSleeper, xHybridSleeper (sequence_sleeper.h) or anything having SleepUntil(clock_t::time_point)
+		/// if sleeper has Interrupt(), it is used as notifier while running. (injection from other thread wakes up the loop)
+		template < typename tSleeper >
+		void Run(tSleeper& sleeper) {
+			// previous notifier is restored on return, and when an exception escapes Dispatch()
+			struct sRestoreNotifier {
+				xWakeQueue* queue{};
+				std::function<void()> fnOld;
+				~sRestoreNotifier() {
+					if (queue)
+						queue->SetNotifier(std::move(fnOld));
+				}
+			} restore;
+			if constexpr (requires { sleeper.Interrupt(); }) {
+				restore.queue = &WakeQueue();
+				restore.fnOld = restore.queue->SetNotifier([&sleeper] { sleeper.Interrupt(); });
+			}
+			for (auto t = Dispatch(); !IsDone(); t = Dispatch())
+				sleeper.SleepUntil(t);
+		}
+
+		// co_await
+		auto Wait(std::function<bool()> pred, clock_t::duration interval, clock_t::duration timeout = clock_t::duration::max(), std::optional<clock_t::duration> slack = {},
+			std::source_location sl = std::source_location::current())
+			requires (tPolicy::bPredicateWait)
+		{
+			xSuspendProfiler::Mark(sl);
+			auto& cold = Cold();
+			if (!cold.pred)
+				cold.pred = std::make_unique<sPredicate>();
+			auto& p = *cold.pred;
+			p.t0 = tPolicy::Now();
+			p.func = std::move(pred);
+			p.interval = interval;
+			p.timeout = timeout;
+			p.slack = slack.value_or(GetDefaultSlack());
+			p.result = {};
+			ReserveResume(interval, p.slack);
+
+			struct sWaitForCondition : public std::suspend_always {
+				mutable std::future<bool> future;
+				constexpr bool await_resume() const noexcept { return future.get(); }
+			};
+			return sWaitForCondition{ std::suspend_always{}, p.result.get_future() };
+		}
+
+		// co_await
+		auto WaitFor(clock_t::duration d, std::optional<clock_t::duration> slack = {}, std::source_location sl = std::source_location::current()) {
+			xSuspendProfiler::Mark(sl);
+			ReserveResume(d, slack.value_or(GetDefaultSlack()));
+			return std::suspend_always{};
+		}
+		// co_await
+		auto WaitUntil(clock_t::time_point t, std::optional<clock_t::duration> slack = {}, std::source_location sl = std::source_location::current()) {
+			xSuspendProfiler::Mark(sl);
+			ReserveResume(t, slack.value_or(GetDefaultSlack()));
+			return std::suspend_always{};
+		}
+		// co_await. parks until the wake handle (GetWakeHandle()) is fired, or timeout.
+		// returns true if woken up by the handle, false on timeout. a wake-up fired before WaitWake() returns at once.
+		auto WaitWake(clock_t::duration timeout = clock_t::duration::max(), std::optional<clock_t::duration> slack = {}, std::source_location sl = std::source_location::current()) {
+			struct sWaitWake {
+				this_t& seq;
+				sWakeNode& node;
+				bool bSignaled{};
+				constexpr bool await_ready() const noexcept { return bSignaled; }
+				constexpr void await_suspend(std::coroutine_handle<>) const noexcept {}
+				bool await_resume() noexcept {
+					seq.Cold().bWaitWake = false;
+					return bSignaled or node.bSignaled.exchange(false, std::memory_order_acq_rel);
+				}
+			};
+			GetWakeHandle();
+			auto& cold = Cold();
+			auto& node = *cold.wakeHandle;
+			bool const bSignaled = node.bSignaled.exchange(false, std::memory_order_acq_rel);
+			if (!bSignaled) {
+				xSuspendProfiler::Mark(sl);
+				cold.bWaitWake = true;
+				auto const t = (timeout == clock_t::duration::max()) ? clock_t::time_point::max() : tPolicy::Now() + timeout;
+				ReserveResume(t, slack.value_or(GetDefaultSlack()));
+			}
+			return sWaitWake{ .seq = *this, .node = node, .bSignaled = bSignaled };
+		}
+		// co_await
+		auto WaitForChild(std::source_location sl = std::source_location::current()) {
+			bool const bReady = !HasChild();
+			if (!bReady)
+				xSuspendProfiler::Mark(sl);
+			ReserveResume(clock_t::duration{});
+			return suspend_or_not{ .bAwaitReady = bReady };
+		}
+
+		// co_await. runs func(seq, element) as a child sequence for each element, at most nConcurrent at a time.
+		// the next element starts as soon as one finishes. coroutine frames are created only when started. (range must outlive co_await)
+		// returns results in the order of the range. after the first error no more elements are started, and the error is rethrown.
+		//		auto results = co_await seq.ForEach(sites, 8, [](seq_t& seq, sSite const& site) { return Inspect(seq, site); });
+		template < std::ranges::input_range tRange, typename tFunc >
+		auto ForEach(tRange&& range, size_t nConcurrent, tFunc&& func, seq_id_t name = {}, std::source_location sl = std::source_location::current()) {
+			using state_t = TForEach<std::views::all_t<tRange>, std::decay_t<tFunc>, false>;
+			return StartForEach(std::make_shared<state_t>(std::views::all(std::forward<tRange>(range)), std::forward<tFunc>(func), std::move(name)), nConcurrent, sl);
+		}
+		// co_await. same as above, but func(element) is a plain function run on pool threads. (cpu-bound work)
+		template < std::ranges::input_range tRange, typename tFunc >
+		auto ForEach(xThreadPool& pool, tRange&& range, size_t nConcurrent, tFunc&& func, std::source_location sl = std::source_location::current()) {
+			using state_t = TForEach<std::views::all_t<tRange>, std::decay_t<tFunc>, true>;
+			auto state = std::make_shared<state_t>(std::views::all(std::forward<tRange>(range)), std::forward<tFunc>(func), seq_id_t{});
+			state->pool = &pool;
+			return StartForEach(std::move(state), nConcurrent, sl);
+		}
+
+		// co_await. runs func on pool thread while this sequence is parked. resumes on the driver thread with the return value of func (or rethrown exception)
+		template < typename tFunc >
+		auto RunInPool(xThreadPool& pool, tFunc&& func, std::source_location sl = std::source_location::current()) {
+			xSuspendProfiler::Mark(sl);
+			using awaiter_t = TPoolAwaiter<std::decay_t<tFunc>>;
+			return awaiter_t{ .pool = pool, .job = std::make_shared<typename awaiter_t::sJob>(std::forward<tFunc>(func), std::nullopt, nullptr, nullptr) };
+		}
+		template < typename tFunc >
+		auto RunInPool(tFunc&& func, std::source_location sl = std::source_location::current()) {
+			return RunInPool(xThreadPool::GetDefault(), std::forward<tFunc>(func), sl);
+		}
+
+	#if defined(__linux__)
+		// co_await. i/o on the driver thread's xIOContext (sequence_io.h). returns result of system call (negative errno on error)
+		auto Read(int fd, std::span<std::byte> buffer, std::source_location sl = std::source_location::current()) { xSuspendProfiler::Mark(sl); return xIOContext::GetCurrent().Read(Self(), fd, buffer); }
+		auto Write(int fd, std::span<std::byte const> buffer, std::source_location sl = std::source_location::current()) { xSuspendProfiler::Mark(sl); return xIOContext::GetCurrent().Write(Self(), fd, buffer); }
+		auto Accept(int fdListen, std::source_location sl = std::source_location::current()) { xSuspendProfiler::Mark(sl); return xIOContext::GetCurrent().Accept(Self(), fdListen); }
+		auto Connect(int fd, sockaddr const* addr, socklen_t addrlen, std::source_location sl = std::source_location::current()) { xSuspendProfiler::Mark(sl); return xIOContext::GetCurrent().Connect(Self(), fd, addr, addrlen); }
+		auto ReadFileAt(int fd, std::span<std::byte> buffer, int64_t offset, std::source_location sl = std::source_location::current()) { xSuspendProfiler::Mark(sl); return xIOContext::GetCurrent().ReadFileAt(Self(), fd, buffer, offset); }
+	#endif
+
+	protected:
+		/// @brief resumes all due sequences of the tree. (driver)
+		/// due sequences are popped from the ready heap. then finished children are swept, and their parents are resumed in the same tick.
+		void DispatchReady(ready_t& ready) {
+			auto const t0 = tPolicy::Now();
+			while (true) {
+				if (auto* seq = ready.PopDue(t0)) {
+					seq->ResumeReady(t0);
+					continue;
+				}
+				if (ready.finished.empty())
+					break;
+				SweepFinished(ready);
+			}
+		}
+
+		/// @brief resumes this sequence. (popped from the ready heap)
+		void ResumeReady(clock_t::time_point t0) {
+			if (HasChild() or !m_handle or m_handle.done())
+				return;	// resumed when its children are done
+			m_tNextDispatch = m_tNextDispatchLatest = clock_t::time_point::max();
+
+			// Dispatch
+			s_seqCurrent = &Self();
+			sCurrentSequence::s_seq = this;
+			sCurrentSequence::s_fnGetWakeNode = [](void* seq) -> std::shared_ptr<sWakeNode> const& { return ((this_t*)seq)->ParkOnWakeNode(); };
+			sCurrentSequence::s_fnReserveResume = [](void* seq, clock_t::duration dur) { ((this_t*)seq)->ReserveResume(dur); };
+			auto* cold = GetCold();
+			bool bResume{true};
+			if (tPolicy::bPredicateWait and cold and cold->pred and cold->pred->func) {
+				auto& pred = *cold->pred;
+				if (t0 - pred.t0 > pred.timeout) {
+					pred.func = nullptr;
+					pred.result.set_value(false);
+				}
+				else if (pred.func()) {
+					pred.func = nullptr;
+					pred.result.set_value(true);
+				}
+				else {
+					ReserveResume(t0+pred.interval, pred.slack);
+					bResume = false;
+				}
+			}
+			if (bResume) {
+				if (cold) {
+					cold->nResume++;
+					cold->bParked = false;
+				}
+				if (auto* profiler = xSuspendProfiler::s_current) [[unlikely]]
+					profiler->Resume(this, m_handle);
+				else
+					m_handle.resume();
+			}
+			s_seqCurrent = nullptr;
+			sCurrentSequence::s_seq = nullptr;
+
+			if (m_handle.done() and !HasChild())
+				Finish();
+			if (auto e = std::exchange(sUnhandledException::s_exception, nullptr)) [[unlikely]] {
+				// finished child is swept at next Dispatch(). (resumes waiting parent)
+				if (cold = GetCold(); !cold or !cold->bKeepException)
+					std::rethrow_exception(e);
+			}
+		}
+
+		/// @brief this sequence is done. its parent erases it at the end of the tick. (driver)
+		void Finish() {
+			if (!m_parent)
+				return;
+			if (std::exchange(m_parent->Cold().bSweep, true))
+				return;
+			m_ready->finished.push_back(m_parent);
+		}
+
+		/// @brief erases finished children. a parent having no more children is resumed (in this tick), or is finished itself. (driver)
+		static void SweepFinished(ready_t& ready) {
+			while (!ready.finished.empty()) {
+				auto* parent = ready.finished.back();
+				ready.finished.pop_back();
+				auto& cold = parent->Cold();
+				cold.bSweep = false;
+				{
+					std::scoped_lock<mutex_t> lock{cold.mtxChildren};
+					cold.children.remove_if([](tSelf const& child) { return child.IsDone(); });
+				}
+				if (!cold.children.empty())
+					continue;
+				if (parent->m_handle and !parent->m_handle.done())
+					parent->SetNextDispatchTime({}, {});	// parent is resumed after its children are done
+				else
+					parent->Finish();
+			}
+		}
+
+		/// @brief sets next dispatch time and updates the ready heap. (driver thread)
+		void SetNextDispatchTime(clock_t::time_point tWhen, clock_t::time_point tLatest) {
+			m_tNextDispatch = tWhen;
+			m_tNextDispatchLatest = tLatest;
+			Schedule();
+		}
+		/// @brief puts this sequence in the ready heap, or takes it out if it can't be resumed by time. (driver thread)
+		void Schedule() {
+			if (!m_ready)
+				return;	// driver
+			if (HasChild() or !m_handle or m_handle.done() or m_tNextDispatch == clock_t::time_point::max())
+				m_ready->Remove(Self());
+			else
+				m_ready->Push(Self());
+		}
+
+		/// @brief calls func(seq) for each descendant. (pre-order. explicit stack, no recursion)
+		template < typename tFunc >
+		void ForEachDescendant(tFunc&& func) const {
+			std::vector<tSelf const*> stack;
+			auto push = [&stack](this_t const& seq) {
+				if (auto const* cold = seq.GetCold()) {
+					for (auto const& child : cold->children | std::views::reverse)
+						stack.push_back(&child);
+				}
+			};
+			push(*this);
+			while (!stack.empty()) {
+				auto const* seq = stack.back();
+				stack.pop_back();
+				func(*seq);
+				push(*seq);
+			}
+		}
+
+		/// @brief appends this subtree to snapshot. (pre-order. explicit stack, no recursion)
+		void FillSnapshot(sSequenceSnapshot& snapshot, clock_t::time_point now) const {
+			using eState = sSequenceSnapshot::eState;
+			struct sItem {
+				this_t const* seq;
+				uint32_t parent;
+				uint32_t depth;
+			};
+			auto const index0 = (uint32_t)snapshot.nodes.size();
+			thread_local std::vector<sItem> stack;	// reused. (no allocation in steady state)
+			stack.clear();
+			stack.push_back(sItem{ this, sSequenceSnapshot::npos, 0 });
+			while (!stack.empty()) {
+				auto const item = stack.back();
+				stack.pop_back();
+				auto const& seq = *item.seq;
+				auto const index = (uint32_t)snapshot.nodes.size();
+				auto& node = snapshot.nodes.emplace_back();
+				node.name = seq.GetName();
+				node.parent = item.parent;
+				node.depth = item.depth;
+				auto const* cold = seq.GetCold();
+				node.nResume = cold ? cold->nResume : 0;
+				if (seq.HasChild())
+					node.state = eState::children;
+				else if (!seq.m_handle or seq.m_handle.done())
+					node.state = eState::done;
+				else if (tPolicy::bPredicateWait and cold and cold->pred and cold->pred->func)
+					node.state = eState::predicate;
+				else if (seq.m_tNextDispatch == clock_t::time_point::max())
+					node.state = eState::parked;
+				else if (seq.m_tNextDispatch <= now)
+					node.state = eState::ready;
+				else
+					node.state = eState::sleeping;
+				// a parent : earliest of its children (below)
+				node.tNextDispatch = seq.HasChild() ? clock_t::time_point::max() : seq.GetNextDispatchTime();
+				node.tNextDispatchLatest = seq.HasChild() ? clock_t::time_point::max() : seq.GetNextDispatchTimeLatest();
+				snapshot.nState[(size_t)node.state]++;
+				if (item.parent != sSequenceSnapshot::npos)
+					snapshot.nodes[item.parent].nChild++;
+				if (!cold)
+					continue;
+				for (auto const& child : cold->children | std::views::reverse)
+					stack.push_back(sItem{ &child, index, item.depth+1 });
+			}
+			// descendants come after their parent
+			for (auto i = (uint32_t)snapshot.nodes.size(); i-- > index0 + 1; ) {
+				auto const& node = snapshot.nodes[i];
+				auto& parent = snapshot.nodes[node.parent];
+				parent.nDescendant += node.nDescendant + 1;
+				parent.tNextDispatch = std::min(parent.tNextDispatch, node.tNextDispatch);
+				parent.tNextDispatchLatest = std::min(parent.tNextDispatchLatest, node.tNextDispatchLatest);
+			}
+		}
+
+	protected:
+		/// @brief creates child sequence. (called by typed CreateChildSequence() of tSelf)
+		/// @param name Task Name
+		/// @param func coroutine function
+		/// @param ...args for coroutine function. must be moved or copied.
+		/// @return 
+		template < typename tCoro, typename ... tArgs >
+		auto CreateChildSequenceT(seq_id_t name, size_t max_sequence_count, std::function<tCoro(tSelf&, tArgs&& ...)> func, tArgs&&... args) {
+			if constexpr (false) {	// todo: do I need this?
+				if (tPolicy::IsOtherThread(m_threadID)) {
+					throw xException("CreateChildSequence() must be called from the same thread as the driver");
+				}
+			}
+
+			auto& cold = Cold();
+			if (max_sequence_count) {
+				std::scoped_lock<mutex_t> lock{cold.mtxChildren};
+				size_t count = std::ranges::count_if(cold.children, [&](auto const& child) { return child.GetName() == name; });
+				if (count >= max_sequence_count) {
+					throw xException("CreateChildSequence() : too many child sequence");
+				}
+			}
+
+			// create child sequence (off the list. linked by the driver thread)
+			children_t batch;
+			auto& seq = batch.emplace_back(std::move(name));
+			// coroutine. coroutine parameters are to be moved (or copied)
+			tCoro coro = func(seq, std::forward<tArgs>(args)...);
+			auto future = coro.GetFuture();	// std::future, or TStream for generators
+			InitChild(seq, coro.Release(), cold);
+			LinkChildren(std::move(batch));
+			return future;
+		}
+
+		/// @brief shared state of ForEach(). (driver thread only)
+		template < typename tView, typename tFunc, bool bPoolT >
+		struct TForEach {
+			static constexpr bool bPool = bPoolT;
+			using reference_t = std::ranges::range_reference_t<tView>;
+			using element_t = std::conditional_t<std::is_lvalue_reference_v<reference_t>, reference_t, std::remove_cvref_t<reference_t>>;
+			using result_t = typename decltype([] {
+				if constexpr (bPoolT)
+					return std::type_identity<std::invoke_result_t<tFunc&, element_t&>>{};
+				else
+					return std::type_identity<decltype(std::declval<std::invoke_result_t<tFunc&, tSelf&, element_t&>&>().GetFuture().get())>{};
+			}())::type;
+			using storage_t = std::conditional_t<std::is_void_v<result_t>, std::monostate, result_t>;
+
+			tView range;
+			tFunc func;
+			seq_id_t name;
+			xThreadPool* pool{};
+			std::ranges::iterator_t<tView> iter;
+			std::vector<std::optional<storage_t>> results;
+			std::exception_ptr error;
+
+			TForEach(tView range, tFunc func, seq_id_t name) : range(std::move(range)), func(std::move(func)), name(std::move(name)), iter(std::ranges::begin(this->range)) {
+				if constexpr (std::ranges::sized_range<tView>)
+					results.reserve(std::ranges::size(this->range));
+			}
+			bool IsEnd() const { return error or iter == std::ranges::end(range); }
+
+			// co_await
+			struct sAwaiter : suspend_or_not {
+				std::shared_ptr<TForEach> state;
+				auto await_resume() {
+					if (state->error)
+						std::rethrow_exception(state->error);
+					if constexpr (!std::is_void_v<result_t>) {
+						std::vector<result_t> results;
+						results.reserve(state->results.size());
+						for (auto& r : state->results)
+							results.push_back(std::move(*r));
+						return results;
+					}
+				}
+			};
+		};
+
+		template < typename tState >
+		auto StartForEach(std::shared_ptr<tState> state, size_t nConcurrent, std::source_location const& sl) {
+			for (size_t i = 0; i < std::max<size_t>(nConcurrent, 1) and !state->IsEnd(); i++) {
+				EmplaceChild({}, [&state](tSelf& worker) { return ForEachWorker(worker, state); });
+			}
+			bool const bReady = !HasChild();	// (empty range)
+			if (!bReady)
+				xSuspendProfiler::Mark(sl);
+			ReserveResume(clock_t::duration{});
+			return typename tState::sAwaiter{ { .bAwaitReady = bReady }, std::move(state) };
+		}
+		/// @brief takes the next element and runs it, until the end of the range. (a worker is a child of the sequence calling ForEach())
+		template < typename tState >
+		static TSimpleCoroutineHandle<bool> ForEachWorker(tSelf& worker, std::shared_ptr<tState> state) {
+			while (!state->IsEnd()) {
+				typename tState::element_t element = *state->iter;
+				++state->iter;
+				auto const index = state->results.size();
+				state->results.emplace_back();
+				try {
+					if constexpr (tState::bPool) {
+						auto job = [state, &element] { return state->func(element); };	// named. (gcc 12 may destroy a lambda temporary in co_await expression twice)
+						if constexpr (std::is_void_v<typename tState::result_t>) {
+							co_await worker.RunInPool(*state->pool, std::move(job));
+							state->results[index].emplace();
+						}
+						else {
+							auto result = co_await worker.RunInPool(*state->pool, std::move(job));
+							state->results[index].emplace(std::move(result));	// (results may be reallocated while suspended)
+						}
+					}
+					else {
+						auto future = worker.EmplaceChild(state->name, [&](tSelf& seq) {
+							seq.Cold().bKeepException = true;	// error goes to the result
+							return state->func(seq, element);
+						});
+						co_await worker.WaitForChild();
+						state->results[index].emplace(future.get());
+					}
+				}
+				catch (...) {
+					if (!state->error)
+						state->error = std::current_exception();
+				}
+			}
+			co_return true;
+		}
+
+		/// @brief appends a child running the coroutine created by fnSpawn(child).
+		/// the child is linked after fnSpawn() returns. if it throws, nothing is added. (the exception propagates)
+		/// @return future of the child
+		template < typename tSpawn >
+		auto EmplaceChild(seq_id_t name, tSpawn&& fnSpawn) {
+			children_t batch;
+			auto& seq = batch.emplace_back(std::move(name));
+			auto coro = fnSpawn(seq);
+			auto future = coro.GetFuture();
+			InitChild(seq, coro.Release(), Cold());
+			LinkChildren(std::move(batch));
+			return future;
+		}
+
+		/// @brief creates children off the list, then links them at once. (CreateChildSequences())
+		template < typename tRange, typename tName, typename tSpawn >
+		auto CreateChildSequencesT(tRange&& range, tName&& fnName, tSpawn&& fnSpawn, size_t max_sequence_count) {
+			using coro_t = std::invoke_result_t<tSpawn&, tSelf&, std::ranges::range_reference_t<tRange>>;
+			using future_t = decltype(std::declval<coro_t&>().GetFuture());
+			using result_t = decltype(std::declval<future_t&>().get());
+
+			std::vector<future_t> futures;
+			if constexpr (std::ranges::sized_range<tRange>)
+				futures.reserve(std::ranges::size(range));
+
+			// create (no lock). coroutine parameters are to be moved (or copied)
+			auto& cold = Cold();
+			children_t batch;
+			for (auto&& spec : range) {
+				auto& seq = batch.emplace_back(seq_id_t(fnName(spec)));
+				coro_t coro = fnSpawn(seq, std::forward<decltype(spec)>(spec));
+				futures.push_back(coro.GetFuture());
+				InitChild(seq, coro.Release(), cold);
+			}
+			if (batch.empty())
+				return TBatch<result_t>(std::move(futures));
+
+			if (max_sequence_count) {
+				std::scoped_lock<mutex_t> lock{cold.mtxChildren};
+				auto const& name = batch.front().GetName();
+				size_t count = std::ranges::count_if(cold.children, [&](auto const& child) { return child.GetName() == name; });
+				if (count + batch.size() > max_sequence_count)
+					throw xException("CreateChildSequences() : too many child sequence");
+			}
+
+			// link. (one lock, one schedule update)
+			LinkChildren(std::move(batch));
+			return TBatch<result_t>(std::move(futures));
+		}
+
+		/// @brief sets up a child created off the list. (not linked yet)
+		void InitChild(tSelf& seq, std::coroutine_handle<> handle, sCold const& cold) {
+			seq.m_handle = handle;
+			seq.m_parent = &Self();
+			seq.m_threadID = m_threadID;
+			seq.m_ready = &Ready();
+			if (auto slack = cold.slack; slack.count())
+				seq.Cold().slack = slack;
+			if (cold.context)
+				seq.Cold().context = cold.context;
+		}
+
+		/// @brief appends children created off the list, and schedules them. (new children are due now)
+		/// children lists are changed only on the driver thread : from other threads, the batch is posted to the driver (and wakes it up).
+		/// the posted task reaches this sequence through its wake node. (if this sequence is gone, the children are destroyed unlinked)
+		void LinkChildren(children_t&& batch) {
+			if (batch.empty())
+				return;
+			if (tPolicy::IsOtherThread(m_threadID)) {
+				auto const& wake = GetWakeNode();
+				wake->queue->Post([wake, children = std::make_shared<children_t>(std::move(batch))] {
+					if (auto* parent = (this_t*)wake->seq)
+						parent->LinkChildren(std::move(*children));
+				});
+				wake->queue->Notify();
+				return;
+			}
+			auto& cold = Cold();
+			auto first = batch.begin();
+			{
+				std::scoped_lock<mutex_t> lock{cold.mtxChildren};	// other threads may be reading. (FindDirectChild())
+				cold.children.splice(cold.children.end(), batch);
+			}
+			Schedule();	// (a parent is resumed after its children are done)
+			for (auto iter = first; iter != cold.children.end(); iter++)
+				iter->Schedule();
+		}
+
+		tSelf& Self() { return static_cast<tSelf&>(*this); }
+		tSelf const& Self() const { return static_cast<tSelf const&>(*this); }
+
+		sCold* GetCold() const { return AtomicLoad(m_cold); }
+		sDriver* GetDriverState() const {
+			auto* cold = GetCold();
+			return cold ? AtomicLoad(cold->driver) : nullptr;
+		}
+		/// @brief driver state. allocates on first use. (thread safe if tPolicy::bMultiThread)
+		sDriver& DriverState() const {
+			auto& cold = Cold();
+			if (auto* driver = AtomicLoad(cold.driver)) [[likely]]
+				return *driver;
+			auto* driver = PolicyNew<tPolicy, sDriver>();
+			sDriver* expected{};
+			if (AtomicCAS(cold.driver, expected, driver))
+				return *driver;
+			PolicyDelete<tPolicy>(driver);
+			return *expected;
+		}
+		/// @brief cold data. allocates on first use. (thread safe if tPolicy::bMultiThread)
+		sCold& Cold() const {
+			if (auto* cold = GetCold()) [[likely]]
+				return *cold;
+			auto* cold = PolicyNew<tPolicy, sCold>();
+			sCold* expected{};
+			if (AtomicCAS(m_cold, expected, cold))
+				return *cold;
+			PolicyDelete<tPolicy>(cold);
+			return *expected;
+		}
+		/// @brief snapshot publisher. allocates on first use. (on demand only until EnableSnapshot())
+		xSnapshotBoard& SnapshotBoard() {
+			auto& driver = DriverState();
+			if (auto* board = AtomicLoad(driver.snapshot))
+				return *board;
+			auto* board = PolicyNew<tPolicy, xSnapshotBoard>(clock_t::duration::max());
+			driver.snapshot = board;
+			return *board;
+		}
+		xDispatchStages* GetDispatchStages() const {
+			auto* driver = GetDriverState();
+			return driver ? driver->stages : nullptr;
+		}
+		ready_t* GetReadyHeap() const {
+			auto* driver = GetDriverState();
+			return driver ? &driver->ready : nullptr;
+		}
+		/// @brief ready heap of the driver (top most). allocates on first use. (thread safe if tPolicy::bMultiThread)
+		ready_t& Ready() const {
+			if (m_ready) [[likely]]
+				return *m_ready;
+			return DriverState().ready;
+		}
+		xWakeQueue* GetWakeQueue() const {
+			auto* driver = GetDriverState();
+			return driver ? AtomicLoad(driver->wakeQueue) : nullptr;
+		}
+		/// @brief wake queue of the driver (top most). allocates on first use. (thread safe if tPolicy::bMultiThread)
+		xWakeQueue& WakeQueue() const {
+			auto& driver = DriverState();
+			if (auto* queue = AtomicLoad(driver.wakeQueue)) [[likely]]
+				return *queue;
+			auto* queue = xWakeQueue::Create();	// (shared with wake nodes)
+			xWakeQueue* expected{};
+			if (AtomicCAS(driver.wakeQueue, expected, queue))
+				return *queue;
+			queue->Close();
+			return *expected;
+		}
+
+	};	// TSequenceBase
+
+}	// namespace gtl::seq::inline v01
@@ -0,0 +1,290 @@
+#pragma once
+
+//////////////////////////////////////////////////////////////////////
+//
+// sequence_channel.h: bounded lock-free channel between sequences and other threads. (SPSC / MPSC)
+//
+// PWH
+// 2026-10-18
+//
+//////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <coroutine>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "sequence_profiler.h"
+#include "sequence_wake.h"
+
+namespace gtl::seq::inline v01 {
+
+	//-------------------------------------------------------------------------
+	/// @brief bounded channel. fixed capacity ring. (rounded up to power of 2)
+	/// single consumer. (bMultiProducer == false : single producer)
+	/// inside a sequence :
+	///		co_await ch.Send(v);					// parks while full
+	///		auto v = co_await ch.Receive();			// parks while empty
+	///		auto n = co_await ch.ReceiveMany(buf);	// parks while empty. receives up to buf.size() items at once
+	/// other threads : TrySend(), TryReceive(), TryReceiveMany()
+	/// full/empty channels park the sequence (no polling). the consumer is woken up only when it is parked.
+	template < typename T, bool bMultiProducer = true >
+	class TChannel {
+	public:
+		using value_t = T;
+
+	protected:
+		struct sCell {
+			std::atomic<size_t> seq;
+			std::optional<T> value;
+		};
+		std::unique_ptr<sCell[]> m_cells;
+		size_t m_mask{};
+		alignas(64) std::atomic<size_t> m_tail{};	// producer(s)
+		alignas(64) size_t m_head{};				// consumer
+
+		// parked consumer
+		alignas(64) std::atomic<bool> m_bReceiverParked{};
+		std::shared_ptr<sWakeNode> m_receiver;		// written by consumer only while not parked
+
+		// parked producers (slow path)
+		std::atomic<size_t> m_nSenderParked{};
+		std::mutex m_mtxSenders;
+		std::vector<std::shared_ptr<sWakeNode>> m_senders;
+
+	public:
+		explicit TChannel(size_t capacity) {
+			capacity = std::bit_ceil(std::max<size_t>(capacity, 2));
+			m_cells = std::make_unique<sCell[]>(capacity);
+			m_mask = capacity - 1;
+			for (size_t i = 0; i < capacity; i++)
+				m_cells[i].seq.store(i, std::memory_order_relaxed);
+		}
+		TChannel(TChannel const&) = delete;
+		TChannel& operator = (TChannel const&) = delete;
+
+		size_t Capacity() const { return m_mask + 1; }
+		bool IsEmpty() const { return m_cells[m_head & m_mask].seq.load(std::memory_order_acquire) != m_head + 1; }
+		bool IsFull() const {
+			auto const pos = m_tail.load(std::memory_order_acquire);
+			return (intptr_t)(m_cells[pos & m_mask].seq.load(std::memory_order_acquire) - pos) < 0;
+		}
+
+		//-----------------------------------
+		/// @brief non-blocking send. can be called from any thread.
+		/// @return false if full. (value is not moved)
+		bool TrySend(T const& value) { return Push(value); }
+		bool TrySend(T&& value) { return Push(std::move(value)); }
+
+		/// @brief non-blocking receive. consumer only.
+		std::optional<T> TryReceive() {
+			std::optional<T> value;
+			if (auto& cell = m_cells[m_head & m_mask]; cell.seq.load(std::memory_order_acquire) == m_head + 1) {
+				value = std::move(cell.value);
+				Release(cell);
+				WakeSenders();
+			}
+			return value;
+		}
+		/// @brief non-blocking receive. consumer only.
+		/// @return number of received items
+		size_t TryReceiveMany(std::span<T> buffer) {
+			size_t n{};
+			for (; n < buffer.size(); n++) {
+				auto& cell = m_cells[m_head & m_mask];
+				if (cell.seq.load(std::memory_order_acquire) != m_head + 1)
+					break;
+				buffer[n] = std::move(*cell.value);
+				Release(cell);
+			}
+			if (n)
+				WakeSenders();
+			return n;
+		}
+
+		//-----------------------------------
+		// co_await. parks current sequence while full.
+		auto Send(T value, std::source_location sl = std::source_location::current()) { xSuspendProfiler::Mark(sl); return sSendAwaiter{ *this, std::move(value) }; }
+		// co_await. parks current sequence while empty.
+		auto Receive(std::source_location sl = std::source_location::current()) { xSuspendProfiler::Mark(sl); return sReceiveAwaiter<false>{ *this }; }
+		// co_await. parks current sequence while empty. returns number of received items. (>= 1 unless buffer is empty)
+		auto ReceiveMany(std::span<T> buffer, std::source_location sl = std::source_location::current()) { xSuspendProfiler::Mark(sl); return sReceiveAwaiter<true>{ *this, buffer }; }
+
+	protected:
+		/// @brief puts value into the ring if not full.
+		template < typename tValue >
+		bool Push(tValue&& value) {
+			auto pos = m_tail.load(std::memory_order_relaxed);
+			while (true) {
+				auto& cell = m_cells[pos & m_mask];
+				auto const seq = cell.seq.load(std::memory_order_acquire);
+				auto const diff = (intptr_t)seq - (intptr_t)pos;
+				if (diff == 0) {
+					if constexpr (bMultiProducer) {
+						if (!m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+							continue;
+					}
+					else {
+						m_tail.store(pos + 1, std::memory_order_relaxed);
+					}
+					cell.value.emplace(std::forward<tValue>(value));
+					cell.seq.store(pos + 1, std::memory_order_release);
+					WakeReceiver();
+					return true;
+				}
+				if (diff < 0)
+					return false;	// full
+				pos = m_tail.load(std::memory_order_relaxed);
+			}
+		}
+		void Release(sCell& cell) {
+			cell.value.reset();
+			cell.seq.store(m_head + m_mask + 1, std::memory_order_release);
+			m_head++;
+		}
+
+		//-----------------------------------
+		// parking. (Dekker style : publish 'parked', then re-check the ring)
+
+		/// @return false if not parked (item arrived meanwhile)
+		bool ParkReceiver(std::shared_ptr<sWakeNode> const& node) {
+			m_receiver = node;
+			m_bReceiverParked.store(true, std::memory_order_seq_cst);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (!IsEmpty() and m_bReceiverParked.exchange(false, std::memory_order_acq_rel))
+				return false;
+			return true;	// (if a producer took the flag, it wakes us up)
+		}
+		void WakeReceiver() {
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (m_bReceiverParked.load(std::memory_order_relaxed) and m_bReceiverParked.exchange(false, std::memory_order_acq_rel)) {
+				auto node = m_receiver;	// copy before Wake(). the consumer may park again right after.
+				node->Wake();
+			}
+		}
+
+		/// @return false if not parked (space freed meanwhile)
+		bool ParkSender(std::shared_ptr<sWakeNode> const& node) {
+			{
+				std::scoped_lock lock{m_mtxSenders};
+				m_senders.push_back(node);
+				m_nSenderParked.store(m_senders.size(), std::memory_order_seq_cst);
+			}
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (IsFull())
+				return true;
+			std::scoped_lock lock{m_mtxSenders};
+			if (auto iter = std::ranges::find(m_senders, node); iter != m_senders.end()) {
+				m_senders.erase(iter);
+				m_nSenderParked.store(m_senders.size(), std::memory_order_relaxed);
+				return false;
+			}
+			return true;	// consumer took it. (wakes us up)
+		}
+		void WakeSenders() {
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (!m_nSenderParked.load(std::memory_order_relaxed))
+				return;
+			std::vector<std::shared_ptr<sWakeNode>> senders;
+			{
+				std::scoped_lock lock{m_mtxSenders};
+				senders.swap(m_senders);
+				m_nSenderParked.store(0, std::memory_order_relaxed);
+			}
+			for (auto& node : senders)
+				node->Wake();
+		}
+
+		//-----------------------------------
+		/// @brief parks the sequence with its own wake node. on wake-up (driver thread), retries before resuming the sequence,
+		/// so the sequence is never resumed without space (send) or item (receive).
+		template < typename tSelf >
+		struct TParkAwaiter {
+			std::shared_ptr<sWakeNode> wake;	// sequence's
+			std::shared_ptr<sWakeNode> node;	// retry node
+
+			TParkAwaiter() = default;
+			TParkAwaiter(TParkAwaiter const&) = delete;
+			TParkAwaiter& operator = (TParkAwaiter const&) = delete;
+			~TParkAwaiter() {
+				if (node)
+					node->seq = nullptr;
+			}
+
+			bool await_suspend(std::coroutine_handle<>) {
+				auto* self = static_cast<tSelf*>(this);
+				wake = sCurrentSequence::GetWakeNode();
+				node = std::make_shared<sWakeNode>();
+				node->queue = wake->queue;
+				node->seq = self;
+				node->fnResume = [](void* p) {
+					auto* self = (tSelf*)p;
+					if (!self->Park())
+						self->wake->Resume();
+				};
+				if (self->Park())
+					return true;
+				xSuspendProfiler::Unmark();
+				return false;
+			}
+			/// @brief ready. (doesn't suspend)
+			static bool Ready() {
+				xSuspendProfiler::Unmark();
+				return true;
+			}
+		};
+
+		struct sSendAwaiter : TParkAwaiter<sSendAwaiter> {
+			TChannel& channel;
+			T value;
+
+			sSendAwaiter(TChannel& channel, T&& value) : channel(channel), value(std::move(value)) {}
+			bool await_ready() { return channel.Push(std::move(value)) and this->Ready(); }
+			/// @return false if sent
+			bool Park() {
+				while (!channel.Push(std::move(value))) {
+					if (channel.ParkSender(this->node))
+						return true;
+				}
+				return false;
+			}
+			void await_resume() const noexcept {}
+		};
+
+		template < bool bMany >
+		struct sReceiveAwaiter : TParkAwaiter<sReceiveAwaiter<bMany>> {
+			TChannel& channel;
+			std::span<T> buffer;
+
+			sReceiveAwaiter(TChannel& channel, std::span<T> buffer = {}) : channel(channel), buffer(buffer) {}
+			bool await_ready() const { return (!channel.IsEmpty() or (bMany and buffer.empty())) and this->Ready(); }
+			/// @return false if an item is ready
+			bool Park() { return channel.IsEmpty() and channel.ParkReceiver(this->node); }
+			auto await_resume() {
+				if constexpr (bMany) {
+					return channel.TryReceiveMany(buffer);
+				}
+				else {
+					auto value = channel.TryReceive();
+					if (!value)
+						throw xException("TChannel::Receive() : no item. (single consumer only)");
+					return std::move(*value);
+				}
+			}
+		};
+
+	};
+
+	template < typename T >
+	using TChannelSPSC = TChannel<T, false>;
+	template < typename T >
+	using TChannelMPSC = TChannel<T, true>;
+
+}	// namespace gtl::seq::inline v01
@@ -9,7 +9,10 @@
 //
 //////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+#include <array>
 #include <coroutine>
+#include <cstdint>
 #include <future>
 #include <chrono>
 #include <exception>
@@ -39,6 +42,57 @@ namespace gtl::seq::inline v01 {
 			base_t(std::format("{}\n\nFile\n\t{}:{}\n\nFunction\n\t{}", msg, sl.file_name(), sl.line(), sl.function_name())) {}
 	};
 
+	//-------------------------------------------------------------------------
+	/// @brief duration histogram. (wake-up jitter, time suspended ...)
+	/// buckets are log2 scaled : [0, 1us), [1us, 2us), [2us, 4us), ... the last bucket takes all the rest.
+	struct sDurationHistogram {
+		static constexpr size_t nBucket = 32;	// 1us ~ 2^30us (18 min)
+
+		std::array<uint64_t, nBucket> buckets{};
+		uint64_t count{};
+		clock_t::duration min{clock_t::duration::max()};
+		clock_t::duration max{clock_t::duration::min()};
+		clock_t::duration sum{};
+
+		void Add(clock_t::duration d) {
+			d = std::max(d, clock_t::duration{});
+			auto const us = (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+			size_t i = 0;
+			for (auto v = us; v and i < nBucket-1; v >>= 1)
+				i++;
+			buckets[i]++;
+			count++;
+			min = std::min(min, d);
+			max = std::max(max, d);
+			sum += d;
+		}
+		void Clear() { *this = {}; }
+
+		/// @brief upper bound of bucket i. (the last bucket has no upper bound)
+		static clock_t::duration BucketUpperBound(size_t i) {
+			if (i >= nBucket-1)
+				return clock_t::duration::max();
+			return std::chrono::microseconds(1ull << i);
+		}
+		clock_t::duration Mean() const { return count ? sum / (int64_t)count : clock_t::duration{}; }
+
+		/// @brief
+		/// @param p : 0.0 ~ 1.0
+		/// @return upper bound of the bucket where the percentile falls in.
+		clock_t::duration Percentile(double p) const {
+			if (!count)
+				return {};
+			auto const target = (uint64_t)std::clamp(p * (double)count, 1.0, (double)count);
+			uint64_t acc{};
+			for (size_t i = 0; i < nBucket; i++) {
+				acc += buckets[i];
+				if (acc >= target)
+					return std::min(BucketUpperBound(i), max);
+			}
+			return max;
+		}
+	};
+
 	//-------------------------------------------------------------------------
 	struct suspend_or_not {
 		bool bAwaitReady{};
@@ -48,42 +102,18 @@ namespace gtl::seq::inline v01 {
 	};
 
 	//-------------------------------------------------------------------------
-	/// @brief used for scheduling
-	struct sState {
-	public:
-		clock_t::time_point tNextDispatch{};
-		mutable clock_t::time_point tNextDispatchChild{ clock_t::time_point::max() };	// cache
-		//bool bDone{false};
-
-		struct sPredicate {
-			std::function<bool()> func;
-			clock_t::time_point t0;
-			clock_t::duration interval, timeout;
-			std::promise<bool> result;
-		};
-		sPredicate pred;
-
-	public:
-		sState(clock_t::time_point t = clock_t::now()) : tNextDispatch(t) {}
-		sState(clock_t::duration d) {
-			tNextDispatch = (d.count() == 0) ? clock_t::time_point{} : clock_t::now() + d;
-		}
-		sState(std::suspend_always) : tNextDispatch(clock_t::time_point::max()) {}
-		sState(std::suspend_never) : tNextDispatch{} {}
-		sState(sState const&) = default;
-		sState(sState&&) = default;
-		sState& operator = (sState const&) = default;
-		sState& operator = (sState&&) = default;
-
-		void Clear() { *this ={}; }
-	};
+	/// @brief t + slack, saturated to time_point::max()
+	inline clock_t::time_point AddSlack(clock_t::time_point t, clock_t::duration slack) {
+		if (slack <= clock_t::duration::zero())
+			return t;
+		if (t > clock_t::time_point::max() - slack)
+			return clock_t::time_point::max();
+		return t + slack;
+	}
 
 	//-------------------------------------------------------------------------
 	template < typename tResult >
 	class TSimpleCoroutineHandle;
-	class ICoroutineHandle;
-	template < typename tResult >
-	class TCoroutineHandle;
 	template < typename tResult, template < typename tResult2 > typename tCoroutineHandle >
 	struct TPromise;
 
@@ -117,51 +147,23 @@ namespace gtl::seq::inline v01 {
 		void Resume() { this->resume(); }
 		bool Done() const { return this->done(); }
 		std::exception_ptr Exception() const { return this->promise().m_exception; }
+		/// @brief future of the result. (co_return)
+		std::future<tResult> GetFuture() { return this->promise().m_result.get_future(); }
+		/// @brief releases ownership of the coroutine frame. (type-erased handle for the dispatcher)
+		std::coroutine_handle<> Release() noexcept { return std::exchange(*(base_t*)this, nullptr); }
 	};
 
 
 	//-------------------------------------------------------------------------
-	/// @brief coroutine handle
-	class ICoroutineHandle {	// interface, pure virtual
-	public:
-		virtual void Destroy() = 0;
-		virtual bool Valid() const = 0;
-		virtual void Resume() = 0;
-		virtual bool Done() const = 0;
-		virtual std::exception_ptr Exception() const = 0;
-	};
-
-	//-------------------------------------------------------------------------
-	/// @brief 
+	/// @brief coroutine handle of sequences having templatized return type. (same as TSimpleCoroutineHandle. no virtual interface)
 	template < typename tResult >
-	class TCoroutineHandle : protected std::coroutine_handle<TPromise<tResult, TCoroutineHandle>>, public ICoroutineHandle {
-	public:
-		using this_t = TCoroutineHandle;
-		using base_t = std::coroutine_handle<TPromise<tResult, TCoroutineHandle>>;
-		using promise_type = TPromise<tResult, TCoroutineHandle>;
-
-	public:
-		TCoroutineHandle(std::coroutine_handle<promise_type>&& h) : base_t(std::exchange(h, nullptr)) {}
-		TCoroutineHandle(TCoroutineHandle const&) = delete;
-		TCoroutineHandle(TCoroutineHandle&& b) : base_t(std::move(b)) { ((base_t&)b) = nullptr; }
-		TCoroutineHandle& operator = (std::nullptr_t) { Destroy(); return *this; }
-		TCoroutineHandle& operator = (TCoroutineHandle const&) = delete;
-		TCoroutineHandle& operator = (TCoroutineHandle&& b) { Destroy(); *(base_t*)this = std::move(b);  ((base_t&)b) = nullptr; return *this;  }
-		virtual ~TCoroutineHandle() { Destroy(); }
+	using TCoroutineHandle = TSimpleCoroutineHandle<tResult>;
 
-	public:
-		using base_t::from_promise;
-		using base_t::promise;
-		using base_t::operator bool;
-		virtual void Destroy() {
-			if (*(base_t*)this)
-				this->destroy();
-			*(base_t*)this = nullptr;
-		}
-		virtual bool Valid() const { return (bool)*(base_t*)this; }
-		virtual void Resume() { this->resume(); }
-		virtual bool Done() const { return this->done(); }
-		virtual std::exception_ptr Exception() const { return this->promise().m_exception; }
+	//-------------------------------------------------------------------------
+	/// @brief exception escaped from the coroutine being resumed.
+	/// set by TPromise::unhandled_exception(), taken and rethrown by the dispatcher right after resume. (type-erased handle can't reach the promise)
+	struct sUnhandledException {
+		inline thread_local static std::exception_ptr s_exception;
 	};
 
 	//-------------------------------------------------------------------------
@@ -178,7 +180,14 @@ namespace gtl::seq::inline v01 {
 		}
 		std::suspend_always initial_suspend() { return {}; }
 		std::suspend_always final_suspend() noexcept { return {}; }
-		void unhandled_exception() { m_exception = std::current_exception(); }
+		void unhandled_exception() {
+			m_exception = std::current_exception();
+			sUnhandledException::s_exception = m_exception;
+			try {
+				m_result.set_exception(m_exception);	// future.get() rethrows
+			}
+			catch (std::future_error const&) {}	// result already set (co_yield)
+		}
 
 		std::suspend_always yield_value(result_t&& v) {
 			m_result.set_value(std::move(v));
@@ -0,0 +1,121 @@
+#pragma once
+
+//////////////////////////////////////////////////////////////////////
+//
+// sequence_fd.h: pollable file descriptor for host event loops (Linux : epoll + timerfd + eventfd)
+//
+// PWH
+// 2026-10-18
+//
+//////////////////////////////////////////////////////////////////////
+
+#if !defined(__linux__)
+#	error "sequence_fd.h : Linux only (timerfd, eventfd, epoll)"
+#endif
+
+#include <cstdint>
+#include <utility>
+
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+
+#include "sequence_sleeper.h"
+
+namespace gtl::seq::inline v01 {
+
+	//-------------------------------------------------------------------------
+	/// @brief pollable fd. becomes readable when the driver has something to dispatch.
+	/// an epoll fd holding a timerfd (next dispatch time) and an eventfd (injection/notification from other threads).
+	/// add GetFD() to any epoll/poll loop (EPOLLIN), and call Dispatch(driver) when it is readable.
+	///
+	///		xDispatchFD fd;
+	///		fd.Attach(driver);
+	///		epoll_ctl(epfd, EPOLL_CTL_ADD, fd.GetFD(), &ev);
+	///		...
+	///		if (ev.data.fd == fd.GetFD())
+	///			fd.Dispatch(driver);
+	///
+	class xDispatchFD {
+	protected:
+		int m_fdEpoll{-1};
+		int m_fdTimer{-1};
+		int m_fdEvent{-1};
+
+	public:
+		xDispatchFD() {
+			m_fdEpoll = epoll_create1(EPOLL_CLOEXEC);
+			m_fdTimer = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC|TFD_NONBLOCK);
+			m_fdEvent = eventfd(0, EFD_CLOEXEC|EFD_NONBLOCK);
+			if (m_fdEpoll < 0 or m_fdTimer < 0 or m_fdEvent < 0) {
+				Close();
+				throw xException("xDispatchFD() : cannot create epoll/timerfd/eventfd");
+			}
+			for (int fd : {m_fdTimer, m_fdEvent}) {
+				epoll_event ev{ .events = EPOLLIN, .data = { .fd = fd } };
+				if (epoll_ctl(m_fdEpoll, EPOLL_CTL_ADD, fd, &ev) < 0) {
+					Close();
+					throw xException("xDispatchFD() : epoll_ctl failed");
+				}
+			}
+		}
+		xDispatchFD(xDispatchFD const&) = delete;
+		xDispatchFD& operator = (xDispatchFD const&) = delete;
+		~xDispatchFD() { Close(); }
+
+		/// @brief fd to poll (EPOLLIN / POLLIN)
+		int GetFD() const { return m_fdEpoll; }
+
+		/// @brief makes fd readable. can be called from any thread.
+		void Notify() {
+			uint64_t v = 1;
+			[[maybe_unused]] auto r = write(m_fdEvent, &v, sizeof(v));
+		}
+
+		/// @brief makes fd readable at t. (time_point::max() : disarm)
+		void Arm(clock_t::time_point t) {
+			itimerspec spec{};
+			if (t != clock_t::time_point::max())
+				spec.it_value = ToMonotonicTimespec(t);
+			timerfd_settime(m_fdTimer, TFD_TIMER_ABSTIME, &spec, nullptr);
+		}
+
+		/// @brief clears readable state
+		void Acknowledge() {
+			uint64_t v{};
+			[[maybe_unused]] auto r1 = read(m_fdTimer, &v, sizeof(v));
+			[[maybe_unused]] auto r2 = read(m_fdEvent, &v, sizeof(v));
+		}
+
+		/// @brief registers Notify() as driver's notifier, and makes fd readable for the first dispatch.
+		template < typename tSequence >
+		void Attach(tSequence& driver) {
+			driver.SetNotifier([this] { Notify(); });
+			Notify();
+		}
+		template < typename tSequence >
+		void Detach(tSequence& driver) {
+			driver.SetNotifier(nullptr);
+			Arm(clock_t::time_point::max());
+		}
+
+		/// @brief call when fd is readable. acknowledges, dispatches and re-arms timer for the next dispatch time.
+		template < typename tSequence >
+		clock_t::time_point Dispatch(tSequence& driver) {
+			Acknowledge();
+			auto t = driver.Dispatch();
+			Arm(t);
+			return t;
+		}
+
+	protected:
+		void Close() {
+			for (int* fd : {&m_fdEpoll, &m_fdTimer, &m_fdEvent}) {
+				if (*fd >= 0)
+					close(std::exchange(*fd, -1));
+			}
+		}
+	};
+
+}	// namespace gtl::seq::inline v01
@@ -0,0 +1,184 @@
+#pragma once
+
+//////////////////////////////////////////////////////////////////////
+//
+// sequence_future.h: promise/future pair. future is co_await-able inside a sequence. (no polling)
+//
+// PWH
+// 2026-10-18
+//
+//////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <future>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "sequence_wake.h"
+
+namespace gtl::seq::inline v01 {
+
+	template < typename T > class TAsyncPromise;
+	template < typename T > class TAsyncFuture;
+
+	//-------------------------------------------------------------------------
+	/// @brief shared state of TAsyncPromise/TAsyncFuture.
+	/// state : empty -> (waiting) -> ready. the value is set from any thread, the waiting sequence is pushed to its driver's wake queue.
+	template < typename T >
+	struct TAsyncState {
+		using value_t = T;
+		using storage_t = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+		enum eState : uint8_t { empty, waiting, ready };
+
+		std::atomic<uint8_t> state{empty};
+		std::optional<storage_t> value;
+		std::exception_ptr exception;
+		std::shared_ptr<sWakeNode> waiter;	// written before 'waiting', read after 'ready'
+
+		bool IsReady() const { return state.load(std::memory_order_acquire) == ready; }
+
+		/// @brief registers waiter.
+		/// @return false if already ready.
+		bool SetWaiter(std::shared_ptr<sWakeNode> node) {
+			waiter = std::move(node);
+			uint8_t expected = empty;
+			if (state.compare_exchange_strong(expected, waiting, std::memory_order_acq_rel))
+				return true;
+			waiter.reset();
+			return false;
+		}
+
+		/// @brief makes ready (after value or exception is set). wakes up waiter.
+		void Publish() {
+			if (state.exchange(ready, std::memory_order_acq_rel) == waiting) {
+				auto node = std::move(waiter);
+				node->Wake();
+			}
+			state.notify_all();
+		}
+
+		/// @brief blocking wait (for non-sequence threads)
+		void Wait() const {
+			for (auto s = state.load(std::memory_order_acquire); s != ready; s = state.load(std::memory_order_acquire))
+				state.wait(s, std::memory_order_acquire);
+		}
+
+		value_t Get() {
+			if (exception)
+				std::rethrow_exception(exception);
+			if constexpr (!std::is_void_v<value_t>)
+				return std::move(*value);
+		}
+	};
+
+	//-------------------------------------------------------------------------
+	/// @brief future. co_await-able inside a sequence. (single consumer)
+	template < typename T >
+	class TAsyncFuture {
+	public:
+		using value_t = T;
+		using state_t = TAsyncState<T>;
+
+	protected:
+		std::shared_ptr<state_t> m_state;
+		friend class TAsyncPromise<T>;
+		TAsyncFuture(std::shared_ptr<state_t> state) : m_state(std::move(state)) {}
+
+	public:
+		TAsyncFuture() = default;
+		TAsyncFuture(TAsyncFuture const&) = delete;
+		TAsyncFuture(TAsyncFuture&&) = default;
+		TAsyncFuture& operator = (TAsyncFuture const&) = delete;
+		TAsyncFuture& operator = (TAsyncFuture&&) = default;
+
+		bool Valid() const { return (bool)m_state; }
+		bool IsReady() const { return m_state and m_state->IsReady(); }
+
+		/// @brief blocking get. (for non-sequence threads). inside a sequence, use co_await.
+		value_t Get() {
+			if (!m_state)
+				throw xException("TAsyncFuture::Get() : no state");
+			m_state->Wait();
+			return std::exchange(m_state, nullptr)->Get();
+		}
+
+		// co_await. parks current sequence until ready. consumes the future : co_await std::move(future)
+		auto operator co_await() && { return sAwaiter{ .state = std::move(m_state) }; }
+
+		struct sAwaiter {
+			std::shared_ptr<state_t> state;
+
+			bool await_ready() const {
+				if (!state)
+					throw xException("TAsyncFuture : no state");
+				return state->IsReady();
+			}
+			bool await_suspend(std::coroutine_handle<>) {
+				// the sequence is parked (no ReserveResume) until the promise wakes it up.
+				return state->SetWaiter(sCurrentSequence::GetWakeNode());
+			}
+			value_t await_resume() { return state->Get(); }
+		};
+	};
+
+	//-------------------------------------------------------------------------
+	/// @brief promise. value (or exception) can be set from any thread.
+	template < typename T >
+	class TAsyncPromise {
+	public:
+		using value_t = T;
+		using state_t = TAsyncState<T>;
+
+	protected:
+		std::shared_ptr<state_t> m_state{std::make_shared<state_t>()};
+		bool m_bFutureRetrieved{};
+
+	public:
+		TAsyncPromise() = default;
+		TAsyncPromise(TAsyncPromise const&) = delete;
+		TAsyncPromise(TAsyncPromise&&) = default;
+		TAsyncPromise& operator = (TAsyncPromise const&) = delete;
+		TAsyncPromise& operator = (TAsyncPromise&& b) {
+			Abandon();
+			m_state = std::move(b.m_state);
+			m_bFutureRetrieved = b.m_bFutureRetrieved;
+			return *this;
+		}
+		~TAsyncPromise() { Abandon(); }
+
+		TAsyncFuture<T> GetFuture() {
+			if (!m_state or std::exchange(m_bFutureRetrieved, true))
+				throw xException("TAsyncPromise::GetFuture() : future already retrieved");
+			return TAsyncFuture<T>(m_state);
+		}
+
+		template < typename ... tArgs >
+		void SetValue(tArgs&& ... args) {
+			auto state = TakeState();
+			state->value.emplace(std::forward<tArgs>(args)...);
+			state->Publish();
+		}
+		void SetException(std::exception_ptr e) {
+			auto state = TakeState();
+			state->exception = std::move(e);
+			state->Publish();
+		}
+
+	protected:
+		std::shared_ptr<state_t> TakeState() {
+			if (!m_state)
+				throw xException("TAsyncPromise : already satisfied");
+			return std::exchange(m_state, nullptr);
+		}
+		void Abandon() {
+			if (m_state and m_bFutureRetrieved)
+				SetException(std::make_exception_ptr(std::future_error(std::future_errc::broken_promise)));
+		}
+	};
+
+}	// namespace gtl::seq::inline v01
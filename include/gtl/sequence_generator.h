@@ -0,0 +1,350 @@
+#pragma once
+
+//////////////////////////////////////////////////////////////////////
+//
+// sequence_generator.h: async generator. a sequence streams values with co_yield. (consumer backpressure)
+//
+// PWH
+// 2026-10-18
+//
+//////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+#include "sequence_coroutine_handle.h"
+#include "sequence_profiler.h"
+#include "sequence_wake.h"
+
+namespace gtl::seq::inline v01 {
+
+	template < typename T > class TGenerator;
+	template < typename T > class TStream;
+
+	//-------------------------------------------------------------------------
+	/// @brief shared state of a generator (producer) and its stream (consumer). allocated once per generator.
+	/// single slot : the producer continues after co_yield if the slot was empty, and is parked at the next co_yield until the consumer takes the value.
+	template < typename T >
+	struct TStreamState {
+		std::mutex mtx;
+		std::optional<T> value;					// slot
+		bool bClosed{};							// producer finished. (co_return, exception, destroyed)
+		bool bCancelled{};						// consumer is gone. values are discarded
+		std::exception_ptr exception;
+		std::shared_ptr<sWakeNode> consumer;	// parked consumer sequence
+		std::shared_ptr<sWakeNode> producer;	// parked producer sequence
+		std::atomic<uint32_t> version{};		// bumped on put and close. (consumer threads wait on it)
+
+		/// @brief wakes up parked sequence. (call after unlock)
+		static void Wake(std::shared_ptr<sWakeNode> node) {
+			if (node)
+				node->Wake();
+		}
+		void Bump() {
+			version.fetch_add(1, std::memory_order_release);
+			version.notify_all();
+		}
+
+		/// @brief puts value into the slot. (lock held)
+		/// @return parked consumer to wake up
+		std::shared_ptr<sWakeNode> Put(T&& v) {
+			value.emplace(std::move(v));
+			return std::exchange(consumer, nullptr);
+		}
+		/// @brief takes value from the slot. (lock held)
+		/// @return parked producer to wake up
+		std::shared_ptr<sWakeNode> Take(std::optional<T>& out) {
+			out = std::exchange(value, std::nullopt);
+			return std::exchange(producer, nullptr);
+		}
+		void Close(std::exception_ptr e = {}) {
+			std::shared_ptr<sWakeNode> node;
+			{
+				std::scoped_lock lock{mtx};
+				if (bClosed)
+					return;
+				bClosed = true;
+				exception = std::move(e);
+				node = std::exchange(consumer, nullptr);
+			}
+			Bump();
+			Wake(std::move(node));
+		}
+	};
+
+	//-------------------------------------------------------------------------
+	/// @brief promise of TGenerator.
+	template < typename T >
+	struct TGeneratorPromise {
+		using value_t = T;
+		using state_t = TStreamState<T>;
+
+		std::shared_ptr<state_t> m_stream{std::make_shared<state_t>()};
+
+		TGeneratorPromise() = default;
+		TGeneratorPromise(TGeneratorPromise const&) = delete;
+		TGeneratorPromise& operator = (TGeneratorPromise const&) = delete;
+		~TGeneratorPromise() { m_stream->Close(); }	// destroyed before finished
+
+		TGenerator<T> get_return_object() { return TGenerator<T>(std::coroutine_handle<TGeneratorPromise>::from_promise(*this)); }
+		std::suspend_always initial_suspend() { return {}; }
+		std::suspend_always final_suspend() noexcept { return {}; }
+		void unhandled_exception() {
+			auto e = std::current_exception();
+			sUnhandledException::s_exception = e;
+			m_stream->Close(e);	// consumer rethrows
+		}
+		void return_void() { m_stream->Close(); }
+
+		/// @brief co_yield v. returns false if the consumer is gone. (value discarded)
+		struct sYieldAwaiter {
+			state_t& stream;
+			std::optional<T> value;
+			bool bConsumed{true};
+
+			/// @brief puts value. no suspension if the slot is empty.
+			bool TryPut() {
+				std::shared_ptr<sWakeNode> node;
+				{
+					std::scoped_lock lock{stream.mtx};
+					if (stream.bCancelled) {
+						value.reset();
+						bConsumed = false;
+						return true;
+					}
+					if (stream.value)
+						return false;
+					node = stream.Put(std::move(*value));
+					value.reset();
+				}
+				stream.Bump();
+				state_t::Wake(std::move(node));
+				return true;
+			}
+			bool await_ready() { return TryPut(); }
+			bool await_suspend(std::coroutine_handle<>) {
+				auto wake = sCurrentSequence::GetWakeNode();
+				{
+					std::scoped_lock lock{stream.mtx};
+					if (stream.value and !stream.bCancelled) {
+						stream.producer = std::move(wake);	// parked until the consumer takes the value
+						return true;
+					}
+				}
+				return !TryPut();
+			}
+			bool await_resume() {
+				if (value)
+					TryPut();	// slot is empty (single producer)
+				return bConsumed;
+			}
+		};
+		sYieldAwaiter yield_value(T v) { return sYieldAwaiter{ .stream = *m_stream, .value = std::move(v) }; }
+	};
+
+	//-------------------------------------------------------------------------
+	/// @brief coroutine handle of a generator sequence. the first parameter of the coroutine is the sequence (like other sequences).
+	///		TGenerator<int> Produce(seq_t& seq) {
+	///			for (int i = 0; i < 10; i++) {
+	///				co_await seq.WaitFor(10ms);
+	///				co_yield i;
+	///			}
+	///		}
+	/// created by seq.CreateGenerator(name, &Produce, args...) which returns TStream<T>.
+	template < typename T >
+	class TGenerator {
+	public:
+		using promise_type = TGeneratorPromise<T>;
+		using this_t = TGenerator;
+
+	protected:
+		std::coroutine_handle<promise_type> m_handle;
+
+	public:
+		explicit TGenerator(std::coroutine_handle<promise_type> h) noexcept : m_handle(h) {}
+		TGenerator(TGenerator const&) = delete;
+		TGenerator(TGenerator&& b) noexcept : m_handle(std::exchange(b.m_handle, nullptr)) {}
+		TGenerator& operator = (TGenerator const&) = delete;
+		TGenerator& operator = (TGenerator&& b) noexcept { Destroy(); m_handle = std::exchange(b.m_handle, nullptr); return *this; }
+		~TGenerator() { Destroy(); }
+
+		void Destroy() {
+			if (auto h = std::exchange(m_handle, nullptr))
+				h.destroy();
+		}
+		promise_type& promise() const { return m_handle.promise(); }
+
+		/// @brief consumer side
+		TStream<T> GetFuture() const { return TStream<T>(promise().m_stream); }
+		/// @brief releases ownership of the coroutine frame. (type-erased handle for the dispatcher)
+		std::coroutine_handle<> Release() noexcept { return std::exchange(m_handle, nullptr); }
+	};
+
+	//-------------------------------------------------------------------------
+	/// @brief consumer side of a generator.
+	/// inside a sequence :
+	///		while (auto v = co_await stream.Next()) { ... }	// parks while no value. std::nullopt at the end
+	/// other threads (blocking) :
+	///		for (auto& v : stream) { ... }
+	/// exception from the generator is rethrown by Next() / Get() / iterator.
+	/// NOTE: a parent sequence is not resumed while it has children. consume the stream from a sequence other than the generator's parent.
+	template < typename T >
+	class TStream {
+	public:
+		using value_t = T;
+		using state_t = TStreamState<T>;
+
+	protected:
+		std::shared_ptr<state_t> m_state;
+		friend class TGenerator<T>;
+		explicit TStream(std::shared_ptr<state_t> state) : m_state(std::move(state)) {}
+
+	public:
+		TStream() = default;
+		TStream(TStream const&) = delete;
+		TStream(TStream&&) = default;
+		TStream& operator = (TStream const&) = delete;
+		TStream& operator = (TStream&& b) { Cancel(); m_state = std::move(b.m_state); return *this; }
+		~TStream() { Cancel(); }
+
+		bool Valid() const { return (bool)m_state; }
+
+		/// @brief non-blocking.
+		/// @return value, or std::nullopt if no value yet (or the end. check IsDone())
+		std::optional<T> TryNext() {
+			std::optional<T> value;
+			if (m_state)
+				TryTake(*m_state, value);
+			return value;
+		}
+		/// @brief true if the generator finished and all values are taken
+		bool IsDone() const {
+			if (!m_state)
+				return true;
+			std::scoped_lock lock{m_state->mtx};
+			return m_state->bClosed and !m_state->value;
+		}
+
+		/// @brief blocking. (for non-sequence threads). inside a sequence, use co_await Next().
+		/// @return std::nullopt at the end
+		std::optional<T> Get() {
+			if (!m_state)
+				throw xException("TStream::Get() : no state");
+			auto& state = *m_state;
+			while (true) {
+				auto const version = state.version.load(std::memory_order_acquire);
+				std::optional<T> value;
+				if (TryTake(state, value))
+					return value;
+				state.version.wait(version, std::memory_order_acquire);
+			}
+		}
+
+		// co_await. parks current sequence until a value arrives. std::nullopt at the end
+		auto Next(std::source_location sl = std::source_location::current()) {
+			if (!m_state)
+				throw xException("TStream::Next() : no state");
+			xSuspendProfiler::Mark(sl);
+			return sAwaiter{ .state = *m_state, .value = std::nullopt, .bTaken = false };
+		}
+
+		/// @brief stops receiving. the generator runs to the end, its values are discarded. (co_yield returns false)
+		void Cancel() {
+			auto state = std::exchange(m_state, nullptr);
+			if (!state)
+				return;
+			std::shared_ptr<sWakeNode> node;
+			{
+				std::scoped_lock lock{state->mtx};
+				state->bCancelled = true;
+				state->value.reset();
+				node = std::exchange(state->producer, nullptr);
+			}
+			state_t::Wake(std::move(node));
+		}
+
+		//-----------------------------------
+		/// @brief input iterator. blocking. (for non-sequence threads)
+		class iterator {
+		public:
+			using iterator_category = std::input_iterator_tag;
+			using value_type = T;
+			using difference_type = std::ptrdiff_t;
+
+		protected:
+			TStream* m_stream{};
+			std::optional<T> m_value;
+
+		public:
+			iterator() = default;
+			explicit iterator(TStream* stream) : m_stream(stream) { ++*this; }
+			T& operator * () { return *m_value; }
+			T* operator -> () { return &*m_value; }
+			iterator& operator ++ () {
+				m_value = m_stream->Get();
+				return *this;
+			}
+			void operator ++ (int) { ++*this; }
+			bool operator == (std::default_sentinel_t) const { return !m_value; }
+		};
+		iterator begin() { return iterator(this); }
+		std::default_sentinel_t end() { return {}; }
+
+	protected:
+		/// @return true if a value was taken or the stream ended (value is std::nullopt). rethrows exception of the generator.
+		static bool TryTake(state_t& state, std::optional<T>& value) {
+			std::shared_ptr<sWakeNode> node;
+			{
+				std::scoped_lock lock{state.mtx};
+				if (!state.value) {
+					if (!state.bClosed)
+						return false;
+					if (state.exception)
+						std::rethrow_exception(state.exception);
+					return true;
+				}
+				node = state.Take(value);
+			}
+			state_t::Wake(std::move(node));
+			return true;
+		}
+
+		struct sAwaiter {
+			state_t& state;
+			std::optional<T> value;
+			bool bTaken{};
+
+			bool await_ready() {
+				if (bTaken = TryTake(state, value); bTaken)
+					xSuspendProfiler::Unmark();
+				return bTaken;
+			}
+			bool await_suspend(std::coroutine_handle<>) {
+				auto wake = sCurrentSequence::GetWakeNode();
+				{
+					std::scoped_lock lock{state.mtx};
+					if (!state.value and !state.bClosed) {
+						state.consumer = std::move(wake);	// parked until the producer puts a value
+						return true;
+					}
+				}
+				xSuspendProfiler::Unmark();
+				bTaken = TryTake(state, value);
+				return false;
+			}
+			std::optional<T> await_resume() {
+				if (!bTaken)
+					TryTake(state, value);
+				return std::move(value);
+			}
+		};
+	};
+
+}	// namespace gtl::seq::inline v01
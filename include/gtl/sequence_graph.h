@@ -0,0 +1,207 @@
+#pragma once
+
+//////////////////////////////////////////////////////////////////////
+//
+// sequence_graph.h: task graph. sequences with dependency edges, results handed along the edges.
+//
+// PWH
+// 2026-10-18
+//
+//////////////////////////////////////////////////////////////////////
+
+#include <exception>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "sequence_base.h"
+
+namespace gtl::seq::inline v01 {
+
+	//-------------------------------------------------------------------------
+	/// @brief dependency graph of sequences. (a tree only lets a parent wait for all of its children)
+	/// a node is started as soon as all of its inputs are done, and gets their results.
+	///		TTaskGraph<seq_t> graph;
+	///		auto home = graph.Add("home", [](seq_t& seq, auto const&) { return Home(seq); });
+	///		auto cal = graph.Add("calibrate", [](seq_t& seq, auto const&) { return Calibrate(seq); });
+	///		auto align = graph.Add("align", [](seq_t& seq, auto const& in) { return Align(seq, in[0], in[1]); }, { home, cal });
+	///		auto results = co_await graph.Run(seq);	// results[align]
+	/// a node can only depend on nodes added before it, so the graph has no cycle.
+	/// the plan (edges, input counts) is built on the first Run() and reused until the graph is changed. (a graph can be run many times, also concurrently)
+	/// tSequence : TSequence<tResult, tPolicy>. all nodes return tResult.
+	template < typename tSequence >
+	class TTaskGraph {
+	public:
+		using seq_t = tSequence;
+		using result_t = typename tSequence::result_t;
+		using coro_t = typename tSequence::coro_t;
+		using node_t = size_t;
+
+	protected:
+		struct sRun;
+
+	public:
+		/// @brief results of the inputs of a node. (in the order of dependencies given to Add())
+		class sInputs {
+		protected:
+			sRun const& m_run;
+			std::span<node_t const> m_deps;
+		public:
+			sInputs(sRun const& run, std::span<node_t const> deps) : m_run(run), m_deps(deps) {}
+			size_t size() const { return m_deps.size(); }
+			result_t const& operator [] (size_t index) const { return *m_run.results[m_deps[index]]; }
+		};
+		using func_t = std::function<coro_t(seq_t&, sInputs const&)>;
+
+	protected:
+		struct sNode {
+			seq_id_t name;
+			func_t func;
+			std::vector<node_t> deps;
+		};
+		/// @brief cached plan. immutable, shared by runs
+		struct sPlan {
+			std::vector<sNode> nodes;
+			std::vector<std::vector<node_t>> dependents;
+			std::vector<uint32_t> nInputs;
+		};
+		/// @brief state of one run. (driver thread only)
+		struct sRun {
+			std::shared_ptr<sPlan const> plan;
+			std::vector<std::optional<result_t>> results;
+			std::vector<uint32_t> nPending;	// inputs not done yet
+			std::vector<seq_t*> nodes;		// parked node sequences
+			std::exception_ptr error;
+		};
+
+		std::vector<sNode> m_nodes;
+		std::shared_ptr<sPlan const> m_plan;	// cache
+
+	public:
+		TTaskGraph() = default;
+
+		/// @brief adds node.
+		/// @param func coroutine function. func(seq, inputs)
+		/// @param deps nodes to be done before this node starts
+		/// @return node. (index of results of Run())
+		node_t Add(seq_id_t name, func_t func, std::initializer_list<node_t> deps = {}) { return Add(std::move(name), std::move(func), std::span<node_t const>(deps.begin(), deps.size())); }
+		node_t Add(seq_id_t name, func_t func, std::span<node_t const> deps) {
+			auto const node = m_nodes.size();
+			for (auto dep : deps) {
+				if (dep >= node)
+					throw xException("TTaskGraph::Add() : dependency must be added before");
+			}
+			m_nodes.push_back(sNode{ std::move(name), std::move(func), { deps.begin(), deps.end() } });
+			m_plan.reset();
+			return node;
+		}
+		size_t size() const { return m_nodes.size(); }
+		void Clear() { m_nodes.clear(); m_plan.reset(); }
+
+		/// @brief builds the plan. (done by Run() if not yet)
+		std::shared_ptr<sPlan const> const& Plan() {
+			if (m_plan)
+				return m_plan;
+			auto plan = std::make_shared<sPlan>();
+			plan->nodes = m_nodes;
+			plan->dependents.resize(m_nodes.size());
+			plan->nInputs.resize(m_nodes.size());
+			for (node_t i = 0; i < m_nodes.size(); i++) {
+				plan->nInputs[i] = (uint32_t)m_nodes[i].deps.size();
+				for (auto dep : m_nodes[i].deps)
+					plan->dependents[dep].push_back(i);
+			}
+			m_plan = std::move(plan);
+			return m_plan;
+		}
+
+		// co_await. runs the graph as child sequences of seq. (call from seq itself)
+		// returns results of all nodes (index : node). after the first error no more nodes are started, and the error is rethrown.
+		auto Run(seq_t& seq, std::source_location sl = std::source_location::current()) {
+			auto run = std::make_shared<sRun>();
+			run->plan = Plan();
+			auto const n = run->plan->nodes.size();
+			run->results.resize(n);
+			run->nPending = run->plan->nInputs;
+			run->nodes.resize(n);
+			try {
+				for (node_t i = 0; i < n; i++) {
+					seq.EmplaceChild({}, [&](seq_t& node) {
+						run->nodes[i] = &node;
+						return RunNode(node, run, i);
+					});
+				}
+			}
+			catch (...) {
+				// nodes created so far are released at once. they skip their functions and end
+				run->error = std::current_exception();
+				for (node_t i = 0; i < n; i++) {
+					run->nPending[i] = 0;
+					if (auto* node = run->nodes[i])
+						node->ReserveResume();
+				}
+				throw;
+			}
+			bool const bReady = !seq.HasChild();	// (empty graph)
+			if (!bReady)
+				xSuspendProfiler::Mark(sl);
+			seq.ReserveResume(clock_t::duration{});
+			return sAwaiter{ { .bAwaitReady = bReady }, std::move(run) };
+		}
+
+	protected:
+		struct sAwaiter : suspend_or_not {
+			std::shared_ptr<sRun> run;
+			std::vector<result_t> await_resume() {
+				if (run->error)
+					std::rethrow_exception(run->error);
+				std::vector<result_t> results;
+				results.reserve(run->results.size());
+				for (auto& r : run->results)
+					results.push_back(std::move(*r));
+				return results;
+			}
+		};
+
+		/// @brief parked until all inputs are done. runs the node as a child sequence, then wakes up dependents whose inputs are all done.
+		/// errors (thrown by the node's coroutine, or by func before returning it) are kept in the run and rethrown by co_await Run().
+		/// the node is released in any case, so its dependents don't wait forever. (after an error, they skip their functions)
+		static TSimpleCoroutineHandle<bool> RunNode(seq_t& self, std::shared_ptr<sRun> run, node_t i) {
+			auto const& node = run->plan->nodes[i];
+			if (run->nPending[i])
+				co_await self.WaitUntil(clock_t::time_point::max());
+			if (!run->error) {
+				try {
+					sInputs inputs(*run, node.deps);
+					auto future = self.EmplaceChild(node.name, [&](seq_t& seq) {
+						seq.Cold().bKeepException = true;	// error goes to the result
+						return node.func(seq, inputs);
+					});
+					co_await self.WaitForChild();
+					auto result = future.get();
+					run->results[i].emplace(std::move(result));
+				}
+				catch (...) {
+					if (!run->error)
+						run->error = std::current_exception();
+				}
+			}
+			Release(*run, i);
+			co_return true;
+		}
+		/// @brief node i is done. dependents whose inputs are all done are resumed in this Dispatch(). (siblings on the driver thread)
+		static void Release(sRun& run, node_t i) {
+			for (auto dependent : run.plan->dependents[i]) {
+				if (!run.nPending[dependent] or --run.nPending[dependent])
+					continue;	// (released already, or waiting for other inputs)
+				if (auto* node = run.nodes[dependent])
+					node->ReserveResume();
+			}
+		}
+	};
+
+}	// namespace gtl::seq::inline v01
@@ -0,0 +1,346 @@
+#pragma once
+
+//////////////////////////////////////////////////////////////////////
+//
+// sequence_io.h: i/o awaitables resumed by the driver (Linux : epoll)
+//
+// PWH
+// 2026-10-18
+//
+//////////////////////////////////////////////////////////////////////
+
+#if !defined(__linux__)
+#	error "sequence_io.h : Linux only (epoll)"
+#endif
+
+#include <cerrno>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <utility>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+
+#include "sequence_profiler.h"
+#include "sequence_sleeper.h"
+
+namespace gtl::seq::inline v01 {
+
+	class xIOContext;
+
+	//-------------------------------------------------------------------------
+	/// @brief i/o operation. lives in the awaiter (coroutine frame) while pending.
+	/// result : same as system call. (negative errno on error)
+	struct sIOOperation {
+		enum class eType : uint8_t { read, write, accept, connect, read_at };
+
+		eType type{};
+		int fd{-1};
+		void* buffer{};
+		size_t size{};
+		int64_t offset{};
+		sockaddr const* addr{};
+		socklen_t addrlen{};
+		bool bStarted{};	// connect
+		bool bRegistered{};
+		ssize_t result{};
+
+		// waiting sequence
+		void* seq{};
+		void (*fnResume)(void* seq){};
+
+		/// @brief performs (or tries) operation.
+		/// @return false if it would block.
+		bool Perform() {
+			ssize_t r{};
+			switch (type) {
+			case eType::read :		r = read(fd, buffer, size); break;
+			case eType::write :		r = write(fd, buffer, size); break;
+			case eType::accept :	r = accept4(fd, nullptr, nullptr, SOCK_NONBLOCK|SOCK_CLOEXEC); break;
+			case eType::read_at :	r = pread(fd, buffer, size, offset); break;
+			case eType::connect :
+				if (!std::exchange(bStarted, true)) {
+					r = connect(fd, addr, addrlen);
+					if (r < 0 and errno == EINPROGRESS)
+						return false;
+				}
+				else {
+					int err{};
+					socklen_t len = sizeof(err);
+					r = getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &len);
+					if (r == 0 and err)
+						r = -1, errno = err;
+				}
+				break;
+			}
+			if (r < 0) {
+				if (errno == EAGAIN or errno == EWOULDBLOCK)
+					return false;
+				if (errno == EINTR)
+					return Perform();
+				r = -errno;
+			}
+			result = r;
+			return true;
+		}
+		uint32_t GetEvents() const {
+			return (type == eType::write or type == eType::connect) ? EPOLLOUT : EPOLLIN;
+		}
+	};
+
+	//-------------------------------------------------------------------------
+	/// @brief awaiter for sIOOperation. tries operation at once, and if it would block, parks the sequence until the fd is ready.
+	template < typename tSequence >
+	struct TIOAwaiter {
+		xIOContext& context;
+		tSequence& seq;
+		sIOOperation op;
+
+		TIOAwaiter(xIOContext& context, tSequence& seq, sIOOperation op) : context(context), seq(seq), op(op) {}
+		TIOAwaiter(TIOAwaiter const&) = delete;
+		TIOAwaiter& operator = (TIOAwaiter const&) = delete;
+		~TIOAwaiter();
+
+		bool await_ready() {
+			if (!op.Perform())
+				return false;
+			xSuspendProfiler::Unmark();
+			return true;
+		}
+		void await_suspend(std::coroutine_handle<>);
+		ssize_t await_resume() const noexcept { return op.result; }
+	};
+
+	//-------------------------------------------------------------------------
+	/// @brief i/o context (epoll) owned by the driver thread.
+	/// it is also a sleeper : waits for i/o readiness and the next dispatch time together. (driver.Run(io))
+	/// regular files are always 'ready' for epoll. ReadFileAt() reads synchronously.
+	/// fds passed to Read/Write/Accept/Connect are switched to non-blocking mode, and left so. (O_NONBLOCK is not restored.
+	/// a socket may have a reader and a writer pending at the same time. use a dup'ed fd if other code needs blocking i/o on it)
+	class xIOContext {
+	protected:
+		int m_fdEpoll{-1};
+		int m_fdTimer{-1};
+		int m_fdEvent{-1};
+		struct sEntry {
+			sIOOperation* in{};
+			sIOOperation* out{};
+			uint32_t events{};
+		};
+		std::unordered_map<int, sEntry> m_entries;
+		inline thread_local static xIOContext* s_current{};
+
+	public:
+		xIOContext() {
+			m_fdEpoll = epoll_create1(EPOLL_CLOEXEC);
+			m_fdTimer = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC|TFD_NONBLOCK);
+			m_fdEvent = eventfd(0, EFD_CLOEXEC|EFD_NONBLOCK);
+			if (m_fdEpoll < 0 or m_fdTimer < 0 or m_fdEvent < 0) {
+				Close();
+				throw xException("xIOContext() : cannot create epoll/timerfd/eventfd");
+			}
+			for (int fd : {m_fdTimer, m_fdEvent}) {
+				epoll_event ev{ .events = EPOLLIN, .data = { .fd = fd } };
+				epoll_ctl(m_fdEpoll, EPOLL_CTL_ADD, fd, &ev);
+			}
+			if (!s_current)
+				s_current = this;
+		}
+		xIOContext(xIOContext const&) = delete;
+		xIOContext& operator = (xIOContext const&) = delete;
+		~xIOContext() {
+			if (s_current == this)
+				s_current = nullptr;
+			Close();
+		}
+
+		/// @brief i/o context of current (driver) thread. the first one created on the thread, or set by MakeCurrent().
+		static xIOContext& GetCurrent() {
+			if (!s_current)
+				throw xException("no xIOContext on this thread");
+			return *s_current;
+		}
+		void MakeCurrent() { s_current = this; }
+
+		/// @brief epoll fd. readable when any i/o is ready or the timer expires. (can be added to other epoll loop)
+		int GetFD() const { return m_fdEpoll; }
+
+		//-----------------------------------
+		// co_await
+		template < typename tSequence >
+		auto Read(tSequence& seq, int fd, std::span<std::byte> buffer) {
+			return TIOAwaiter<tSequence>(*this, seq, {.type = sIOOperation::eType::read, .fd = SetNonBlock(fd), .buffer = buffer.data(), .size = buffer.size()});
+		}
+		template < typename tSequence >
+		auto Write(tSequence& seq, int fd, std::span<std::byte const> buffer) {
+			return TIOAwaiter<tSequence>(*this, seq, {.type = sIOOperation::eType::write, .fd = SetNonBlock(fd), .buffer = (void*)buffer.data(), .size = buffer.size()});
+		}
+		/// @return accepted socket (non-blocking) or negative errno
+		template < typename tSequence >
+		auto Accept(tSequence& seq, int fdListen) {
+			return TIOAwaiter<tSequence>(*this, seq, {.type = sIOOperation::eType::accept, .fd = SetNonBlock(fdListen)});
+		}
+		/// @return 0 or negative errno
+		template < typename tSequence >
+		auto Connect(tSequence& seq, int fd, sockaddr const* addr, socklen_t addrlen) {
+			return TIOAwaiter<tSequence>(*this, seq, {.type = sIOOperation::eType::connect, .fd = SetNonBlock(fd), .addr = addr, .addrlen = addrlen});
+		}
+		template < typename tSequence >
+		auto ReadFileAt(tSequence& seq, int fd, std::span<std::byte> buffer, int64_t offset) {
+			return TIOAwaiter<tSequence>(*this, seq, {.type = sIOOperation::eType::read_at, .fd = fd, .buffer = buffer.data(), .size = buffer.size(), .offset = offset});
+		}
+
+		//-----------------------------------
+		/// @brief registers pending operation. (one reader and one writer per fd)
+		void Register(sIOOperation& op) {
+			auto& entry = m_entries[op.fd];
+			auto& slot = (op.GetEvents() & EPOLLIN) ? entry.in : entry.out;
+			if (slot)
+				throw xException("xIOContext::Register() : another operation is pending on the fd");
+			slot = &op;
+			op.bRegistered = true;
+			if (!Update(op.fd, entry)) {
+				// not pollable (ex, regular file). complete synchronously
+				Complete(op.fd, entry, op, false);
+			}
+		}
+		/// @brief removes pending operation (awaiting sequence is being destroyed)
+		void Cancel(sIOOperation& op) {
+			if (!std::exchange(op.bRegistered, false))
+				return;
+			auto iter = m_entries.find(op.fd);
+			if (iter == m_entries.end())
+				return;
+			auto& entry = iter->second;
+			if (entry.in == &op) entry.in = nullptr;
+			if (entry.out == &op) entry.out = nullptr;
+			Update(op.fd, entry);
+			if (!entry.in and !entry.out)
+				m_entries.erase(iter);
+		}
+
+		//-----------------------------------
+		/// @brief processes ready operations (and resumes waiting sequences) without blocking
+		/// @return number of completed operations
+		size_t Poll() { return Wait(0); }
+
+		/// @brief sleeper interface. waits for i/o or t, and processes ready operations.
+		void SleepUntil(clock_t::time_point t) {
+			itimerspec spec{};
+			if (t != clock_t::time_point::max())
+				spec.it_value = ToMonotonicTimespec(t);
+			timerfd_settime(m_fdTimer, TFD_TIMER_ABSTIME, &spec, nullptr);
+			Wait(-1);
+		}
+		/// @brief wakes up sleeping thread. can be called from any thread.
+		void Interrupt() {
+			uint64_t v = 1;
+			[[maybe_unused]] auto r = write(m_fdEvent, &v, sizeof(v));
+		}
+
+	protected:
+		/// @brief sets O_NONBLOCK. (permanently. see above)
+		static int SetNonBlock(int fd) {
+			if (int flags = fcntl(fd, F_GETFL); flags >= 0 and !(flags & O_NONBLOCK))
+				fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+			return fd;
+		}
+
+		bool Update(int fd, sEntry& entry) {
+			uint32_t events = (entry.in ? (uint32_t)EPOLLIN : 0u) | (entry.out ? (uint32_t)EPOLLOUT : 0u);
+			if (events == entry.events)
+				return true;
+			epoll_event ev{ .events = events, .data = { .fd = fd } };
+			int r{};
+			if (!events)
+				r = epoll_ctl(m_fdEpoll, EPOLL_CTL_DEL, fd, &ev);
+			else if (!entry.events)
+				r = epoll_ctl(m_fdEpoll, EPOLL_CTL_ADD, fd, &ev);
+			else
+				r = epoll_ctl(m_fdEpoll, EPOLL_CTL_MOD, fd, &ev);
+			if (r < 0 and events)
+				return false;
+			entry.events = events;
+			return true;
+		}
+
+		void Complete(int fd, sEntry& entry, sIOOperation& op, bool bPerform = true) {
+			if (bPerform and !op.Perform())
+				return;	// spurious
+			if (!bPerform) {
+				// blocking fallback. (not registered to epoll) parks the thread on the fd until it is ready
+				while (!op.Perform()) {
+					pollfd pfd{ .fd = fd, .events = (short)(op.GetEvents() == EPOLLIN ? POLLIN : POLLOUT), .revents = 0 };
+					if (poll(&pfd, 1, -1) < 0 and errno != EINTR) {
+						op.result = -errno;
+						break;
+					}
+				}
+			}
+			(entry.in == &op ? entry.in : entry.out) = nullptr;
+			op.bRegistered = false;
+			Update(fd, entry);
+			op.fnResume(op.seq);
+		}
+
+		size_t Wait(int timeout_ms) {
+			epoll_event events[64];
+			int n{};
+			do {
+				n = epoll_wait(m_fdEpoll, events, std::size(events), timeout_ms);
+			} while (n < 0 and errno == EINTR);
+
+			size_t count{};
+			uint64_t v{};
+			for (int i = 0; i < n; i++) {
+				int fd = events[i].data.fd;
+				if (fd == m_fdTimer or fd == m_fdEvent) {
+					[[maybe_unused]] auto r = read(fd, &v, sizeof(v));
+					continue;
+				}
+				auto iter = m_entries.find(fd);
+				if (iter == m_entries.end())
+					continue;
+				auto& entry = iter->second;
+				auto const ev = events[i].events;
+				if (entry.in and (ev & (EPOLLIN|EPOLLERR|EPOLLHUP)))
+					Complete(fd, entry, *entry.in), count++;
+				if (entry.out and (ev & (EPOLLOUT|EPOLLERR|EPOLLHUP)))
+					Complete(fd, entry, *entry.out), count++;
+				if (!entry.in and !entry.out)
+					m_entries.erase(iter);
+			}
+			return count;
+		}
+
+		void Close() {
+			for (int* fd : {&m_fdEpoll, &m_fdTimer, &m_fdEvent}) {
+				if (*fd >= 0)
+					close(std::exchange(*fd, -1));
+			}
+		}
+	};
+
+	//-------------------------------------------------------------------------
+	template < typename tSequence >
+	TIOAwaiter<tSequence>::~TIOAwaiter() {
+		if (op.bRegistered)
+			context.Cancel(op);
+	}
+	template < typename tSequence >
+	void TIOAwaiter<tSequence>::await_suspend(std::coroutine_handle<>) {
+		// sequence is parked (no ReserveResume) until the operation completes.
+		op.seq = &seq;
+		op.fnResume = [](void* seq) { ((tSequence*)seq)->ReserveResume(); };
+		context.Register(op);
+	}
+
+}	// namespace gtl::seq::inline v01
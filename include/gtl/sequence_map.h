@@ -10,21 +10,28 @@
 //
 //////////////////////////////////////////////////////////////////////
 
+#include <concepts>
+#include <algorithm>
 #include <set>
 #include <map>
+#include <list>
+#include <unordered_map>
+#include <vector>
 #include "sequence.h"
+#include "sequence_future.h"
 
 namespace gtl::seq::inline v01 {
 
 	//-------------------------------------------------------------------------
 	/// @brief sequence map (unit tree, sequence function map) manager
-	template < typename tResult, typename tParam = tResult >
+	template < typename tResult, typename tParam = tResult, typename tPolicy = sPolicyMultiThread >
 	class TSequenceMap {
 	public:
 		using this_t = TSequenceMap;
 		using result_t = tResult;
 		using param_t = tParam;
-		using seq_t = TSequence<result_t>;
+		using policy_t = tPolicy;
+		using seq_t = TSequence<result_t, tPolicy>;
 		using coro_t = seq_t::coro_t;
 
 		using unit_id_t = std::string;
@@ -32,14 +39,127 @@ namespace gtl::seq::inline v01 {
 	public:
 		using this_t = TSequenceMap;
 		using handler_t = std::function<coro_t(seq_t&, param_t&&)>;
+		using fnDone_t = std::function<void(result_t const* result, std::exception_ptr e)>;
+		/// @brief running sequences of a single-flight handler. callers with equal param attach to the running one.
+		struct sFlights {
+			struct sFlight {
+				param_t params;
+				std::vector<fnDone_t> waiters;
+			};
+			typename tPolicy::mutex_t mtx;
+			std::list<sFlight> running;
+			typename tPolicy::template atomic_t<size_t> nHit{}, nMiss{};
+		};
+		struct sFlightStats {
+			size_t nHit{};	// attached to the running sequence
+			size_t nMiss{};	// started new sequence
+		};
+
+		/// @brief what to do with a request when max_sequence_count sequences of a handler are running
+		enum class eAdmission : uint8_t {
+			reject,		// throws xException
+			fifo,		// queued. started in order as running ones finish
+			priority,	// queued. higher fnPriority(param) first. (fifo among equals)
+		};
+		struct sAdmissionOption {
+			eAdmission policy{eAdmission::reject};
+			size_t queue_depth{};	// max queued requests. (0 : unlimited). rejected (xException) if full
+			std::function<int(param_t const&)> fnPriority;	// eAdmission::priority
+		};
+		struct sAdmissionStats {
+			size_t nRunning{};
+			size_t nQueued{};		// current queue depth
+			size_t nMaxQueued{};	// high water mark of queue depth
+			size_t nStarted{};		// started at once
+			size_t nDequeued{};		// started from the queue
+			size_t nRejected{};
+			size_t nFailed{};		// dequeued requests failed to start. (the error went to the caller)
+			std::exception_ptr lastError;	// of the last failed one
+			clock_t::duration tWaitTotal{};	// of dequeued requests
+			clock_t::duration tWaitMax{};
+		};
+		/// @brief admission of a handler having max_sequence_count. counts running sequences, queues requests over the limit.
+		struct sAdmission {
+			size_t max_sequence_count{};
+			sAdmissionOption option;
+			struct sPending {
+				int priority{};
+				uint64_t order{};
+				clock_t::time_point tQueued;
+				std::function<void(bool bDequeued)> start;
+			};
+			mutable typename tPolicy::mutex_t mtx;
+			std::vector<sPending> queue;	// heap. (higher priority, then older first)
+			uint64_t order{};
+			sAdmissionStats stats;
+
+			static bool Later(sPending const& a, sPending const& b) { return a.priority != b.priority ? a.priority < b.priority : a.order > b.order; }
+
+			/// @brief starts now if under the limit (start(false)). queues (or rejects) if not. (start(true) when dequeued)
+			/// @return false if rejected. (start is not called)
+			bool Admit(int priority, std::function<void(bool bDequeued)> start) {
+				{
+					std::scoped_lock lock{mtx};
+					if (stats.nRunning >= max_sequence_count) {
+						if (option.policy == eAdmission::reject or (option.queue_depth and queue.size() >= option.queue_depth)) {
+							stats.nRejected++;
+							return false;
+						}
+						queue.push_back({ .priority = option.policy == eAdmission::priority ? priority : 0, .order = order++, .tQueued = tPolicy::Now(), .start = std::move(start) });
+						std::ranges::push_heap(queue, Later);
+						stats.nQueued = queue.size();
+						stats.nMaxQueued = std::max(stats.nMaxQueued, stats.nQueued);
+						return true;
+					}
+					stats.nRunning++;
+					stats.nStarted++;
+				}
+				start(false);
+				return true;
+			}
+			/// @brief a sequence finished (or was dropped). starts next queued one.
+			void Release() {
+				std::function<void(bool)> start;
+				{
+					std::scoped_lock lock{mtx};
+					if (queue.empty()) {
+						stats.nRunning--;
+						return;
+					}
+					std::ranges::pop_heap(queue, Later);
+					auto pending = std::move(queue.back());
+					queue.pop_back();
+					auto const tWait = tPolicy::Now() - pending.tQueued;
+					stats.nQueued = queue.size();
+					stats.nDequeued++;
+					stats.tWaitTotal += tWait;
+					stats.tWaitMax = std::max(stats.tWaitMax, tWait);
+					start = std::move(pending.start);
+				}
+				start(true);
+			}
+			/// @brief a dequeued request failed to start. (the error went to the caller) kept for GetAdmissionStats()
+			void Failed(std::exception_ptr e) {
+				std::scoped_lock lock{mtx};
+				stats.nFailed++;
+				stats.lastError = std::move(e);
+			}
+		};
+
 		struct sHandler {
 			handler_t handler;
 			size_t max_sequence_count{};
+			std::shared_ptr<sFlights> flights;	// single-flight only. (shared by copies of the handler)
+			std::shared_ptr<sAdmission> admission;	// if max_sequence_count. (shared by copies of the handler)
 		};
 		using map_t = std::map<seq_id_t, sHandler>;
 
 	private:
-		mutable seq_t* m_sequence_driver{};	// only valid if (m_parent == nullptr). (std::variant<this_t*, seq_t*> : too verbose)
+		mutable seq_t* m_sequence_driver{};	// driver of this unit and its sub units (shard). if nullptr, parent's driver.
+		// cache. refreshed when the unit tree or driver changes (Register, Unregister, SetSequenceDriver)
+		seq_t* m_driver{};		// resolved driver (this unit's or nearest parent's)
+		this_t* m_top{this};	// top most unit
+		std::unordered_multimap<unit_id_t, this_t*> m_index;	// top most only. all units of the tree by name
 	protected:
 		unit_id_t m_unit;
 		this_t* m_parent{};
@@ -49,11 +169,17 @@ namespace gtl::seq::inline v01 {
 	public:
 		// constructors and destructor
 		TSequenceMap(unit_id_t unit) : m_unit(std::move(unit)) {
+			m_index.emplace(m_unit, this);
 		}
-		TSequenceMap(unit_id_t unit, this_t& parent) : m_unit(std::move(unit)), m_parent(&parent) {
-			m_parent->Register(this);
+		TSequenceMap(unit_id_t unit, this_t& parent) : m_unit(std::move(unit)) {
+			parent.Register(this);
 		}
-		TSequenceMap(unit_id_t unit, seq_t& driver) : m_unit(std::move(unit)), m_sequence_driver(&driver) {
+		TSequenceMap(unit_id_t unit, seq_t& driver) : m_sequence_driver(&driver), m_driver(&driver), m_unit(std::move(unit)) {
+			m_index.emplace(m_unit, this);
+		}
+		/// @brief unit (and its sub units) pinned to other driver (shard). sequences of this unit run on that driver's thread.
+		TSequenceMap(unit_id_t unit, this_t& parent, seq_t& driver) : m_sequence_driver(&driver), m_unit(std::move(unit)) {
+			parent.Register(this);
 		}
 		~TSequenceMap() {
 			while (m_mapChildren.size()) {	// children can outlive parents
@@ -76,9 +202,17 @@ namespace gtl::seq::inline v01 {
 			m_unit = std::exchange(b.m_unit, {});
 			m_sequence_driver = std::exchange(b.m_sequence_driver, nullptr);
 			m_mapChildren.swap(b.m_mapChildren);
+			for (auto* child : m_mapChildren)
+				child->m_parent = this;
+			b.m_index.clear();
+			b.RefreshCache();
 
-			if (m_parent)
-				m_parent->Register(this);
+			if (auto* parent = std::exchange(m_parent, nullptr))
+				parent->Register(this);
+			else {
+				RefreshCache();
+				IndexSubTree(this, true);
+			}
 		}
 		TSequenceMap& operator = (TSequenceMap&&) = delete;	// if this has some children, no way to remove children from parent
 		//TSequenceMap& operator = (TSequenceMap&& b) {
@@ -92,39 +226,101 @@ namespace gtl::seq::inline v01 {
 		// 
 		//	// for children, update m_top
 		//}
-		inline this_t* GetTopMost() { auto* p = this; while (p->m_parent) p = p->m_parent; return p; }
-		inline this_t const* GetTopMost() const { auto const* p = this; while (p->m_parent) p = p->m_parent; return p; }
-		seq_t* GetSequenceDriver() const { if (auto* top = GetTopMost()) return top->m_sequence_driver; return nullptr; }
+		inline this_t* GetTopMost() { return m_top; }
+		inline this_t const* GetTopMost() const { return m_top; }
+		seq_t* GetSequenceDriver() const { return m_driver; }
+		/// @brief pins this unit (and its sub units) to driver. (nullptr : parent's driver)
+		void SetSequenceDriver(seq_t* driver) {
+			m_sequence_driver = driver;
+			RefreshCache();
+		}
 		auto const& GetUnitName() const { return m_unit; }
-		auto* GetCurrentSequence() { return GetSequenceDriver()->GetCurrentSequence(); }
-		auto const* GetCurrentSequence() const { return GetSequenceDriver()->GetCurrentSequence(); }
+		/// @brief current running sequence of this thread. (thread local, O(1))
+		auto* GetCurrentSequence() const { return seq_t::GetCurrentSequence(); }
 		//-----------------------------------
 		/// @brief Register/Unregister this unit
 		inline void Register(this_t* child) {
 			if (child) {
-				if (auto* p = std::exchange(child->m_parent, nullptr); p) {
+				if (auto* p = child->m_parent)
 					p->Unregister(child);
-				}
 				child->m_parent = this;
-				child->m_sequence_driver = nullptr;
 				m_mapChildren.insert(child);
+				child->m_index.clear();	// not top most any more
+				child->RefreshCache();
+				m_top->IndexSubTree(child, true);
 			}
 		}
 		inline void Unregister(this_t* child) {
-			if (child) {
+			if (child and m_mapChildren.erase(child)) {
+				m_top->IndexSubTree(child, false);
 				child->m_parent = nullptr;
-				m_mapChildren.erase(child);
+				child->RefreshCache();
+				child->IndexSubTree(child, true);	// child is top most now
 			}
 		}
 
+		/// @brief finds unit by name in the whole unit tree. (index of the top most unit)
+		this_t* FindUnit(unit_id_t const& unit) const {
+			auto const& index = m_top->m_index;
+			if (auto iter = index.find(unit); iter != index.end())
+				return iter->second;
+			return nullptr;
+		}
+
+	protected:
+		/// @brief refreshes cached top most unit and driver of this sub tree.
+		void RefreshCache() {
+			m_top = m_parent ? m_parent->m_top : this;
+			m_driver = m_sequence_driver ? m_sequence_driver : (m_parent ? m_parent->m_driver : nullptr);
+			for (auto* child : m_mapChildren)
+				child->RefreshCache();
+		}
+		/// @brief adds (removes) units of sub tree to (from) the index. (top most only)
+		void IndexSubTree(this_t* unit, bool bAdd) {
+			if (bAdd) {
+				m_index.emplace(unit->m_unit, unit);
+			}
+			else {
+				auto [first, last] = m_index.equal_range(unit->m_unit);
+				for (auto iter = first; iter != last; iter++) {
+					if (iter->second == unit) {
+						m_index.erase(iter);
+						break;
+					}
+				}
+			}
+			for (auto* child : unit->m_mapChildren)
+				IndexSubTree(child, bAdd);
+		}
+
+	public:
+
 		//-----------------------------------
 		/// @brief Bind/Unbind sequence function with name
-		inline bool Bind(seq_id_t const& id, handler_t handler, size_t max_sequence_count = 0) {
+		/// @param max_sequence_count : max running sequences of this handler. (0 : unlimited)
+		/// @param admission : what to do with requests over max_sequence_count. (reject, or queue)
+		/// @param bSingleFlight : if a sequence of this handler with equal param is running, callers attach to it and get its result
+		/// instead of starting a new one. (param_t must be equality comparable)
+		inline bool Bind(seq_id_t const& id, handler_t handler, size_t max_sequence_count = 0, bool bSingleFlight = false) {
+			return Bind(id, std::move(handler), max_sequence_count, sAdmissionOption{}, bSingleFlight);
+		}
+		inline bool Bind(seq_id_t const& id, handler_t handler, size_t max_sequence_count, sAdmissionOption admission, bool bSingleFlight = false) {
+			if constexpr (!std::equality_comparable<param_t>) {
+				if (bSingleFlight)
+					throw xException("Bind() : single-flight needs equality comparable param");
+			}
 			if (auto iter = m_mapFuncs.find(id); iter != m_mapFuncs.end())
 				return false;
 			auto& h = m_mapFuncs[id];
 			h.handler = handler;
 			h.max_sequence_count = max_sequence_count;
+			if (bSingleFlight)
+				h.flights = std::make_shared<sFlights>();
+			if (max_sequence_count) {
+				h.admission = std::make_shared<sAdmission>();
+				h.admission->max_sequence_count = max_sequence_count;
+				h.admission->option = std::move(admission);
+			}
 			return true;
 		}
 		inline bool Unbind(seq_id_t const& id) {
@@ -136,8 +332,12 @@ namespace gtl::seq::inline v01 {
 		}
 	protected:
 		template < typename tSelf > requires std::is_base_of_v<this_t, tSelf>
-		inline bool Bind(seq_id_t const& id, coro_t(tSelf::* handler)(seq_t&, param_t), size_t max_sequence_count = 0) {
-			return Bind(id, std::bind(handler, (tSelf*)(this), std::placeholders::_1, std::placeholders::_2), max_sequence_count);
+		inline bool Bind(seq_id_t const& id, coro_t(tSelf::* handler)(seq_t&, param_t), size_t max_sequence_count = 0, bool bSingleFlight = false) {
+			return Bind(id, std::bind(handler, (tSelf*)(this), std::placeholders::_1, std::placeholders::_2), max_sequence_count, bSingleFlight);
+		}
+		template < typename tSelf > requires std::is_base_of_v<this_t, tSelf>
+		inline bool Bind(seq_id_t const& id, coro_t(tSelf::* handler)(seq_t&, param_t), size_t max_sequence_count, sAdmissionOption admission, bool bSingleFlight = false) {
+			return Bind(id, std::bind(handler, (tSelf*)(this), std::placeholders::_1, std::placeholders::_2), max_sequence_count, std::move(admission), bSingleFlight);
 		}
 
 	public:
@@ -149,6 +349,20 @@ namespace gtl::seq::inline v01 {
 			static sHandler const empty;
 			return empty;
 		}
+		/// @brief single-flight counters of handler 'sequence'
+		sFlightStats GetFlightStats(seq_id_t const& sequence) const {
+			if (auto const& flights = FindHandler(sequence).flights)
+				return { .nHit = flights->nHit, .nMiss = flights->nMiss };
+			return {};
+		}
+		/// @brief admission counters of handler 'sequence'. (running, queue depth, wait time, ...)
+		sAdmissionStats GetAdmissionStats(seq_id_t const& sequence) const {
+			if (auto const& admission = FindHandler(sequence).admission) {
+				std::scoped_lock lock{admission->mtx};
+				return admission->stats;
+			}
+			return {};
+		}
 
 		//-----------------------------------
 		// Find Map
@@ -193,23 +407,235 @@ namespace gtl::seq::inline v01 {
 		//}
 
 		//-----------------------------------
-		inline auto CreateSequence(seq_t* parent, unit_id_t unit, seq_id_t name, seq_id_t running, param_t params = {}) {
-			this_t* unitTarget = unit.empty() ? this : GetTopMost()->FindUnitDFS(unit);
-			if (!unitTarget)
+		/// @brief creates sequence 'name' of 'unit' under 'parent' (default: current sequence, or the unit's driver).
+		/// if the unit is owned by other driver (shard) than the parent's, the request is posted to the owning driver through its mailbox,
+		/// and the sequence runs there under the driver.
+		/// single-flight handler, handler having max_sequence_count, or unit of other driver : a child sequence waiting for the result is created instead.
+		/// (parent's WaitForChild() works the same, even if the request is queued, attached to the running one, or runs on other driver)
+		inline std::future<result_t> CreateSequence(seq_t* parent, unit_id_t unit, seq_id_t name, seq_id_t running, param_t params = {}) {
+			auto target = FindTarget(parent, unit, name);
+			if (!running.empty())
+				name = std::move(running);
+			if (target.handler->flights or target.handler->admission or target.IsRemote()) {
+				auto promise = std::make_shared<TAsyncPromise<result_t>>();
+				auto future = promise->GetFuture();
+				fnDone_t fnDone = [promise](result_t const* result, std::exception_ptr e) {
+					if (result) promise->SetValue(*result); else promise->SetException(e);
+				};
+				if (auto const& flights = target.handler->flights; !flights or !AttachFlight(flights, params, fnDone))
+					StartRelay(target, name, std::move(params), std::move(fnDone));
+				return CreateAwait(*target.parent, std::move(future));
+			}
+			return target.parent->template CreateChildSequence<param_t>(std::move(name), 0, target.handler->handler, std::move(params));
+		}
+
+		/// @brief same as CreateSequence(), but returns awaitable future. (co_await inside a sequence)
+		inline TAsyncFuture<result_t> CallSequence(seq_t* parent, unit_id_t const& unit, seq_id_t name, param_t params = {}) {
+			auto target = FindTarget(parent, unit, name);
+			auto promise = std::make_shared<TAsyncPromise<result_t>>();
+			auto future = promise->GetFuture();
+			fnDone_t fnDone = [promise](result_t const* result, std::exception_ptr e) {
+				if (result) promise->SetValue(*result); else promise->SetException(e);
+			};
+			if (auto const& flights = target.handler->flights; flights and AttachFlight(flights, params, fnDone))
+				return future;
+			StartRelay(target, std::move(name), std::move(params), std::move(fnDone));
+			return future;
+		}
+		inline auto CallSequence(unit_id_t const& unit, seq_id_t name, param_t params = {}) {
+			return CallSequence(nullptr, unit, std::move(name), std::move(params));
+		}
+
+	protected:
+		struct sTarget {
+			this_t* unit{};
+			seq_t* parent{};
+			seq_t* driver{};
+			sHandler const* handler{};
+			bool IsRemote() const { return driver and driver->GetWorkingThreadID() != parent->GetWorkingThreadID(); }
+		};
+		sTarget FindTarget(seq_t* parent, unit_id_t const& unit, seq_id_t const& name) {
+			sTarget target;
+			target.unit = unit.empty() ? this : FindUnit(unit);
+			if (!target.unit)
 				throw xException("no unit");
+			target.driver = target.unit->GetSequenceDriver();
 			if (!parent)
-				parent = unitTarget->GetCurrentSequence();	// current sequence
+				parent = seq_t::GetCurrentSequence();	// current sequence
 			if (!parent)
-				parent = unitTarget->GetSequenceDriver();	// top most
+				parent = target.driver;	// top most
 			if (!parent)
 				throw xException("no parent seq");
-			auto handler = unitTarget->FindHandler(name);
-			if (!handler.handler)
+			target.parent = parent;
+			target.handler = &target.unit->FindHandler(name);
+			if (!target.handler->handler)
 				throw xException("no handler");
-			return parent->CreateChildSequence<param_t>(
-				running.empty() ? std::move(name) : std::move(running), handler.max_sequence_count, handler.handler, std::move(params));
+			return target;
+		}
+
+		/// @brief relay sequence. runs handler as its child, and passes the result to fnDone.
+		struct sRelay {
+			handler_t handler;
+			param_t params;
+			seq_id_t name;
+			fnDone_t fnDone;
+		};
+		static coro_t Relay(seq_t& seq, sRelay relay) {
+			seq.Cold().bKeepException = true;	// error goes to the caller (fnDone)
+			std::optional<result_t> result;
+			try {
+				auto future = seq.template CreateChildSequence<param_t>(relay.name, 0, relay.handler, std::move(relay.params));	// (handler may throw)
+				co_await seq.WaitForChild();
+				result.emplace(future.get());
+			}
+			catch (...) {
+				relay.fnDone(nullptr, std::current_exception());
+				throw;
+			}
+			relay.fnDone(&*result, nullptr);
+			co_return std::move(*result);
+		}
+		static std::future<result_t> CreateRelay(seq_t& parent, seq_id_t name, sHandler const& handler, param_t params, fnDone_t fnDone) {
+			std::function<coro_t(seq_t&, sRelay&&)> relay = [](seq_t& seq, sRelay&& r) { return Relay(seq, std::move(r)); };
+			return parent.template CreateChildSequence<sRelay>(seq_id_t(name), 0, std::move(relay),
+				sRelay{ .handler = handler.handler, .params = std::move(params), .name = std::move(name), .fnDone = std::move(fnDone) });
+		}
+		/// @brief fnDone called exactly once : explicitly, or with broken_promise when its last copy is destroyed without being called.
+		/// (relay destroyed by its driver, posted relay dropped by a closed mailbox, queued request dropped ...)
+		/// so single-flight waiters and admission slots are released on every path.
+		static fnDone_t GuardDone(fnDone_t fnDone) {
+			struct sCompletion {
+				fnDone_t fnDone;
+				~sCompletion() {
+					if (!fnDone)
+						return;
+					try {
+						fnDone(nullptr, std::make_exception_ptr(std::future_error(std::future_errc::broken_promise)));
+					}
+					catch (...) {}
+				}
+			};
+			return [completion = std::make_shared<sCompletion>(std::move(fnDone))](result_t const* result, std::exception_ptr e) {
+				if (auto fn = std::exchange(completion->fnDone, nullptr))
+					fn(result, e);
+			};
 		}
 
+		/// @brief starts relay, through admission of the handler. (queued or rejected if max_sequence_count sequences are running)
+		/// a relay started at once runs under the caller. a queued one may start after the caller is gone :
+		/// it is posted to the caller's driver and runs under it, not under the caller. (the caller gets the result through fnDone)
+		static void StartRelay(sTarget const& target, seq_id_t name, param_t params, fnDone_t fnDone) {
+			fnDone = GuardDone(std::move(fnDone));
+			auto const& admission = target.handler->admission;
+			if (!admission) {
+				RunRelay(target, std::move(name), std::move(params), std::move(fnDone));
+				return;
+			}
+			int const priority = admission->option.fnPriority ? admission->option.fnPriority(params) : 0;
+			auto wake = target.parent->GetDriver().GetWakeNode();	// reaches the driver of a dequeued relay. (nothing, if it is gone)
+			auto fnRejected = fnDone;	// (single-flight : erases the flight registered for this request, and fails its waiters)
+			bool const bAdmitted = admission->Admit(priority, [target, wake, weak = std::weak_ptr(admission), handler = *target.handler, name = std::move(name), params = std::move(params), fnDone = std::move(fnDone)](bool bDequeued) mutable {
+				// the slot is released when the request is done, however it ends
+				fnDone = GuardDone([admission = weak.lock(), fnDone = std::move(fnDone)](result_t const* result, std::exception_ptr e) {
+					fnDone(result, e);
+					admission->Release();
+				});
+				if (!bDequeued) {
+					auto t = target;
+					t.handler = &handler;
+					RunRelay(t, std::move(name), std::move(params), std::move(fnDone));
+					return;
+				}
+				// dequeued by Release(), which may run while a dropped relay is destroyed : started by the driver's next Dispatch()
+				wake->queue->Post([wake, target, weak, handler = std::move(handler), name = std::move(name), params = std::move(params), fnDone = std::move(fnDone)]() mutable {
+					auto* driver = static_cast<seq_t*>(static_cast<typename seq_t::base_t*>(wake->seq));
+					if (!driver)
+						return;	// (fnDone is dropped : broken_promise)
+					auto t = target;
+					t.parent = driver;
+					t.handler = &handler;
+					try {
+						RunRelay(t, std::move(name), std::move(params), std::move(fnDone));
+					}
+					catch (...) {
+						if (auto admission = weak.lock())
+							admission->Failed(std::current_exception());
+					}
+				});
+				wake->queue->Notify();
+			});
+			if (!bAdmitted) {
+				auto e = std::make_exception_ptr(xException("too many sequence. (admission)"));
+				fnRejected(nullptr, e);
+				std::rethrow_exception(e);
+			}
+		}
+		/// @brief starts relay. (local : child of target.parent, remote : posted to the target driver)
+		static void RunRelay(sTarget const& target, seq_id_t name, param_t params, fnDone_t fnDone) {
+			if (target.IsRemote()) {
+				PostRelay(target, std::move(name), std::move(params), std::move(fnDone));
+				return;
+			}
+			try {
+				CreateRelay(*target.parent, std::move(name), *target.handler, std::move(params), fnDone);
+			}
+			catch (...) {
+				fnDone(nullptr, std::current_exception());	// (releases single-flight)
+				throw;
+			}
+		}
+		/// @brief posts relay to the target driver (mailbox). runs on the driver thread.
+		static void PostRelay(sTarget const& target, seq_id_t name, param_t params, fnDone_t fnDone) {
+			target.driver->Post([driver = target.driver, handler = *target.handler, name = std::move(name), params = std::move(params), fnDone = std::move(fnDone)]() mutable {
+				try {
+					CreateRelay(*driver, std::move(name), handler, std::move(params), fnDone);
+				}
+				catch (...) {
+					fnDone(nullptr, std::current_exception());
+				}
+			});
+		}
+
+		/// @brief single-flight. if a sequence having equal params is running, attaches fnDone to it and returns true.
+		/// if not, registers new flight, and replaces fnDone with the one delivering the result to all attached callers.
+		static bool AttachFlight(std::shared_ptr<sFlights> const& flights, param_t const& params, fnDone_t& fnDone) {
+			std::scoped_lock lock{flights->mtx};
+			if constexpr (std::equality_comparable<param_t>) {
+				for (auto& flight : flights->running) {
+					if (flight.params == params) {
+						flights->nHit++;
+						flight.waiters.push_back(std::move(fnDone));
+						return true;
+					}
+				}
+			}
+			flights->nMiss++;
+			auto& flight = flights->running.emplace_back(params);
+			flight.waiters.push_back(std::move(fnDone));
+			fnDone = [flights, iter = std::prev(flights->running.end())](result_t const* result, std::exception_ptr e) {
+				std::vector<fnDone_t> waiters;
+				{
+					std::scoped_lock lock{flights->mtx};
+					waiters.swap(iter->waiters);
+					flights->running.erase(iter);
+				}
+				for (auto& fn : waiters)
+					fn(result, e);
+			};
+			return false;
+		}
+
+		/// @brief child sequence waiting for the result of other sequence. (single-flight)
+		/// unnamed. not counted for max_sequence_count
+		static coro_t AwaitResult(seq_t&, TAsyncFuture<result_t> future) {
+			co_return co_await std::move(future);
+		}
+		static std::future<result_t> CreateAwait(seq_t& parent, TAsyncFuture<result_t> future) {
+			std::function<coro_t(seq_t&, TAsyncFuture<result_t>&&)> await = [](seq_t& seq, TAsyncFuture<result_t>&& f) { return AwaitResult(seq, std::move(f)); };
+			return parent.template CreateChildSequence<TAsyncFuture<result_t>>(seq_id_t{}, 0, std::move(await), std::move(future));
+		}
+
+	public:
 		// root sequence
 		inline auto CreateRootSequence(unit_id_t const& unit, seq_id_t name, param_t params) {
 			return CreateSequence(GetSequenceDriver(), unit, std::move(name), {}, std::move(params));
@@ -247,26 +673,27 @@ namespace gtl::seq::inline v01 {
 		}
 
 		// co_await
-		auto WaitFor(clock_t::duration d) {
+		auto WaitFor(clock_t::duration d, std::optional<clock_t::duration> slack = {}, std::source_location sl = std::source_location::current()) {
 			if (auto* cur = GetCurrentSequence())
-				return cur->WaitFor(d);
+				return cur->WaitFor(d, slack, sl);
 			throw xException("WaitFor() must be called from sequence function");
 		}
 		// co_await
-		auto WaitUntil(clock_t::time_point t) {
+		auto WaitUntil(clock_t::time_point t, std::optional<clock_t::duration> slack = {}, std::source_location sl = std::source_location::current()) {
 			if (auto* cur = GetCurrentSequence())
-				return cur->WaitUntil(t);
+				return cur->WaitUntil(t, slack, sl);
 			throw xException("WaitFor() must be called from sequence function");
 		}
 		// co_await
-		auto WaitForChild() {
+		auto WaitForChild(std::source_location sl = std::source_location::current()) {
 			if (auto* cur = GetCurrentSequence())
-				return cur->WaitForChild();
+				return cur->WaitForChild(sl);
 			throw xException("WaitFor() must be called from sequence function");
 		}
-		auto Wait(std::function<bool()> pred, clock_t::duration interval, clock_t::duration timeout = clock_t::duration::max()) {
+		auto Wait(std::function<bool()> pred, clock_t::duration interval, clock_t::duration timeout = clock_t::duration::max(), std::optional<clock_t::duration> slack = {},
+			std::source_location sl = std::source_location::current()) {
 			if (auto* cur = GetCurrentSequence())
-				return cur->Wait(std::move(pred), interval, timeout);
+				return cur->Wait(std::move(pred), interval, timeout, slack, sl);
 			throw xException("Wait() must be called from sequence function");
 		}
 	};
@@ -0,0 +1,190 @@
+#pragma once
+
+//////////////////////////////////////////////////////////////////////
+//
+// sequence_observable.h: observable value. waiting sequences are woken up only when the value changes. (no polling)
+//
+// PWH
+// 2026-10-18
+//
+//////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <concepts>
+#include <coroutine>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <source_location>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "sequence_coroutine_handle.h"
+#include "sequence_profiler.h"
+#include "sequence_wake.h"
+
+namespace gtl::seq::inline v01 {
+
+	//-------------------------------------------------------------------------
+	/// @brief value shared by sequences and other threads. Set() wakes up only the sequences waiting on this value.
+	/// inside a sequence :
+	///		bool ok = co_await door.WaitUntil([](bool closed) { return closed; }, 5s);	// false on timeout
+	/// other threads (or sequences) :
+	///		door.Set(true);
+	/// predicates are evaluated on the driver thread of the waiting sequence, once when waiting and then only after Set().
+	/// idle waiters cost nothing between updates. (no timer, no polling)
+	/// predicates run under the lock of the observable : keep them short, and don't access the observable from them.
+	/// the observable must outlive the sequences waiting on it.
+	template < typename T >
+	class TObservable {
+	public:
+		using value_t = T;
+
+	protected:
+		mutable std::mutex m_mtx;
+		T m_value{};
+		uint64_t m_version{};
+		std::vector<std::shared_ptr<sWakeNode>> m_waiters;	// parked waiters. (woken up and removed by Set())
+
+	public:
+		TObservable() = default;
+		explicit TObservable(T value) : m_value(std::move(value)) {}
+		TObservable(TObservable const&) = delete;
+		TObservable& operator = (TObservable const&) = delete;
+
+		T Get() const {
+			std::scoped_lock lock(m_mtx);
+			return m_value;
+		}
+		/// @brief number of changes
+		uint64_t GetVersion() const {
+			std::scoped_lock lock(m_mtx);
+			return m_version;
+		}
+
+		/// @brief sets value and wakes up waiters. can be called from any thread.
+		/// setting an equal value does nothing. (if T is equality comparable)
+		template < typename U = T >
+		bool Set(U&& value) {
+			return Update([&value](T& v) {
+				if constexpr (std::equality_comparable_with<T const&, U const&>) {
+					if (v == value)
+						return false;
+				}
+				v = std::forward<U>(value);
+				return true;
+			});
+		}
+
+		/// @brief modifies value in place. func(T&) returns false if nothing changed. (waiters are not woken up)
+		/// can be called from any thread.
+		template < typename tFunc >
+		bool Update(tFunc&& func) {
+			std::vector<std::shared_ptr<sWakeNode>> waiters;
+			{
+				std::scoped_lock lock(m_mtx);
+				if constexpr (std::is_void_v<std::invoke_result_t<tFunc, T&>>)
+					std::invoke(std::forward<tFunc>(func), m_value);
+				else if (!std::invoke(std::forward<tFunc>(func), m_value))
+					return false;
+				m_version++;
+				waiters.swap(m_waiters);
+			}
+			for (auto& node : waiters)
+				node->Wake();
+			return true;
+		}
+
+		// co_await. parks until pred(value) is true, or timeout. returns false on timeout.
+		// does not suspend if pred(value) is already true.
+		template < typename tPred >
+		auto WaitUntil(tPred&& pred, clock_t::duration timeout = clock_t::duration::max(), std::source_location sl = std::source_location::current()) {
+			xSuspendProfiler::Mark(sl);
+			return TWaitAwaiter<std::decay_t<tPred>>(*this, std::forward<tPred>(pred), timeout);
+		}
+
+	protected:
+		//-----------------------------------
+		/// @brief parks the sequence with its own wake node. on wake-up (driver thread), evaluates the predicate before resuming the sequence,
+		/// so the sequence is resumed only when the predicate is true. (or on timeout)
+		template < typename tPred >
+		struct TWaitAwaiter {
+			TObservable& obs;
+			tPred pred;
+			clock_t::duration timeout;
+			uint64_t version{};	// of the value pred was evaluated with
+			bool bSatisfied{};
+			std::shared_ptr<sWakeNode> wake;	// sequence's
+			std::shared_ptr<sWakeNode> node;	// registered to the observable
+
+			TWaitAwaiter(TObservable& obs, tPred&& pred, clock_t::duration timeout) : obs(obs), pred(std::move(pred)), timeout(timeout) {}
+			TWaitAwaiter(TObservable& obs, tPred const& pred, clock_t::duration timeout) : obs(obs), pred(pred), timeout(timeout) {}
+			TWaitAwaiter(TWaitAwaiter const&) = delete;
+			TWaitAwaiter& operator = (TWaitAwaiter const&) = delete;
+			~TWaitAwaiter() {
+				if (!node)
+					return;
+				node->seq = nullptr;
+				obs.Unpark(node);
+			}
+
+			bool await_ready() {
+				std::scoped_lock lock(obs.m_mtx);
+				version = obs.m_version;
+				if (bSatisfied = std::invoke(pred, std::as_const(obs.m_value)); bSatisfied)
+					xSuspendProfiler::Unmark();
+				return bSatisfied;
+			}
+			bool await_suspend(std::coroutine_handle<>) {
+				wake = sCurrentSequence::GetWakeNode();
+				node = std::make_shared<sWakeNode>();
+				node->queue = wake->queue;
+				node->seq = this;
+				node->fnResume = [](void* p) {
+					auto* self = (TWaitAwaiter*)p;
+					if (!self->Park())
+						self->wake->Resume();
+				};
+				if (!Park()) {
+					xSuspendProfiler::Unmark();
+					return false;
+				}
+				if (timeout != clock_t::duration::max())
+					sCurrentSequence::ReserveResume(timeout);
+				return true;
+			}
+			bool await_resume() {
+				if (node) {
+					node->seq = nullptr;
+					obs.Unpark(node);
+					node.reset();
+				}
+				return bSatisfied;
+			}
+
+			/// @brief evaluates the predicate if the value has changed. registers node if false.
+			/// @return true if parked
+			bool Park() {
+				std::scoped_lock lock(obs.m_mtx);
+				if (version != obs.m_version) {
+					version = obs.m_version;
+					if (bSatisfied = std::invoke(pred, std::as_const(obs.m_value)); bSatisfied)
+						return false;
+				}
+				obs.m_waiters.push_back(node);
+				return true;
+			}
+		};
+
+		void Unpark(std::shared_ptr<sWakeNode> const& node) {
+			std::scoped_lock lock(m_mtx);
+			if (auto iter = std::find(m_waiters.begin(), m_waiters.end(), node); iter != m_waiters.end()) {
+				*iter = std::move(m_waiters.back());
+				m_waiters.pop_back();
+			}
+		}
+	};
+
+}	// namespace gtl::seq::inline v01
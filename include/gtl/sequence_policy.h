@@ -0,0 +1,141 @@
+#pragma once
+
+//////////////////////////////////////////////////////////////////////
+//
+// sequence_policy.h: compile-time policy of sequences (threading model, predicate wait, clock, allocator)
+//
+// PWH
+// 2026-10-18
+//
+//////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "sequence_coroutine_handle.h"
+
+namespace gtl::seq::inline v01 {
+
+	//-------------------------------------------------------------------------
+	/// @brief mutex doing nothing. (single thread policy)
+	struct xNullMutex {
+		constexpr void lock() noexcept {}
+		constexpr void unlock() noexcept {}
+		constexpr bool try_lock() noexcept { return true; }
+	};
+
+	/// @brief thread id of single thread policy. (all sequences are on the same thread)
+	struct sNoThreadID {
+		constexpr bool operator == (sNoThreadID const&) const noexcept = default;
+	};
+
+	//-------------------------------------------------------------------------
+	/// @brief default policy.
+	/// sequences can be created, woken up and searched from other threads. (mutex, thread id check)
+	///
+	/// a policy provides :
+	///		bMultiThread : false - no mutex, no atomic, no thread id check. everything must be done on the driver thread.
+	///		bPredicateWait : Wait(pred, interval, timeout) support
+	///		mutex_t, thread_id_t, GetThreadID(), IsOtherThread(id)
+	///		Now() : clock of the scheduler. (must return clock_t::time_point. ex, coarse clock or simulated time)
+	///		allocator_t<T> : allocator for child list and cold data. (stateless)
+	struct sPolicyMultiThread {
+		static constexpr bool bMultiThread = true;
+		static constexpr bool bPredicateWait = true;
+
+		using mutex_t = std::mutex;
+		using thread_id_t = std::thread::id;
+		template < typename T >
+		using atomic_t = std::atomic<T>;
+		template < typename T >
+		using allocator_t = std::allocator<T>;
+
+		static thread_id_t GetThreadID() noexcept { return std::this_thread::get_id(); }
+		static bool IsOtherThread(thread_id_t const& id) noexcept { return std::this_thread::get_id() != id; }
+		static clock_t::time_point Now() { return clock_t::now(); }
+	};
+
+	//-------------------------------------------------------------------------
+	/// @brief single thread policy. all synchronization is compiled out.
+	/// sequences must be created and dispatched on the driver thread only.
+	/// (futures, channels, RunInPool still work. they wake up sequences through the lock-free wake queue)
+	struct sPolicySingleThread : sPolicyMultiThread {
+		static constexpr bool bMultiThread = false;
+
+		using mutex_t = xNullMutex;
+		using thread_id_t = sNoThreadID;
+		template < typename T >
+		using atomic_t = T;
+
+		static constexpr thread_id_t GetThreadID() noexcept { return {}; }
+		static constexpr bool IsOtherThread(thread_id_t const&) noexcept { return false; }
+	};
+
+	//-------------------------------------------------------------------------
+	/// @brief removes Wait(pred) support. (no predicate check in Dispatch)
+	template < typename tPolicy >
+	struct TPolicyNoPredicateWait : tPolicy {
+		static constexpr bool bPredicateWait = false;
+	};
+
+	//-------------------------------------------------------------------------
+	/// @brief load/store/cas for policy's atomic_t. (plain pointer if single thread)
+	template < typename T >
+	T* AtomicLoad(std::atomic<T*> const& a) noexcept { return a.load(std::memory_order_acquire); }
+	template < typename T >
+	T* AtomicLoad(T* const& a) noexcept { return a; }
+	template < typename T >
+	bool AtomicCAS(std::atomic<T*>& a, T*& expected, T* desired) noexcept { return a.compare_exchange_strong(expected, desired, std::memory_order_acq_rel); }
+	template < typename T >
+	bool AtomicCAS(T*& a, T*& expected, T* desired) noexcept {
+		if (a != expected) {
+			expected = a;
+			return false;
+		}
+		a = desired;
+		return true;
+	}
+
+	template < typename T >
+	T* AtomicExchange(std::atomic<T*>& a, T* desired) noexcept { return a.exchange(desired, std::memory_order_acq_rel); }
+	template < typename T >
+	T* AtomicExchange(T*& a, T* desired) noexcept { return std::exchange(a, desired); }
+
+	/// @brief load/store of policy's atomic_t<bool>. (flag publishing data written before it)
+	inline bool AtomicLoad(std::atomic<bool> const& a) noexcept { return a.load(std::memory_order_acquire); }
+	inline bool AtomicLoad(bool const& a) noexcept { return a; }
+	inline void AtomicStore(std::atomic<bool>& a, bool value) noexcept { a.store(value, std::memory_order_release); }
+	inline void AtomicStore(bool& a, bool value) noexcept { a = value; }
+
+	//-------------------------------------------------------------------------
+	/// @brief new/delete with policy's allocator
+	template < typename tPolicy, typename T, typename ... tArgs >
+	T* PolicyNew(tArgs&& ... args) {
+		using alloc_t = typename tPolicy::template allocator_t<T>;
+		using traits_t = std::allocator_traits<alloc_t>;
+		alloc_t alloc;
+		auto* p = traits_t::allocate(alloc, 1);
+		try {
+			traits_t::construct(alloc, p, std::forward<tArgs>(args)...);
+		}
+		catch (...) {
+			traits_t::deallocate(alloc, p, 1);
+			throw;
+		}
+		return p;
+	}
+	template < typename tPolicy, typename T >
+	void PolicyDelete(T* p) {
+		if (!p)
+			return;
+		using alloc_t = typename tPolicy::template allocator_t<T>;
+		using traits_t = std::allocator_traits<alloc_t>;
+		alloc_t alloc;
+		traits_t::destroy(alloc, p);
+		traits_t::deallocate(alloc, p, 1);
+	}
+
+}	// namespace gtl::seq::inline v01
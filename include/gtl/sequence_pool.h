@@ -0,0 +1,213 @@
+#pragma once
+
+//////////////////////////////////////////////////////////////////////
+//
+// sequence_pool.h: thread pool for cpu-heavy steps. the sequence resumes on its driver thread.
+//
+// PWH
+// 2026-10-18
+//
+//////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+#include "sequence_coroutine_handle.h"
+#include "sequence_wake.h"
+
+namespace gtl::seq::inline v01 {
+
+	//-------------------------------------------------------------------------
+	/// @brief worker pool, with fixed number of threads. the queue can be bounded (nQueueMax) :
+	/// Submit() blocks the calling thread while the queue is full, TrySubmit() rejects the job,
+	/// and a sequence (co_await RunInPool()) stays parked until its job gets in. (the driver thread never blocks)
+	class xThreadPool {
+	public:
+		struct sStats {
+			size_t nThread{};
+			size_t nQueueMax{};		// queue limit. (0 : unlimited)
+			size_t nQueued{};		// waiting in queue
+			size_t nQueuedMax{};	// max queue depth
+			size_t nParked{};		// jobs of parked sequences waiting for room in the queue
+			size_t nRunning{};
+			uint64_t nSubmitted{};
+			uint64_t nCompleted{};
+			uint64_t nRejected{};	// TrySubmit()
+		};
+
+	protected:
+		mutable std::mutex m_mtx;
+		std::condition_variable m_cv;
+		std::condition_variable m_cvRoom;	// Submit() waiting for room in the queue
+		std::deque<std::function<void()>> m_jobs;
+		std::deque<std::function<void()>> m_parked;	// SubmitParked(). (one job per parked sequence at most)
+		sStats m_stats;
+		bool m_bStop{};
+		std::vector<std::jthread> m_threads;
+
+	public:
+		explicit xThreadPool(size_t nThread = std::max(1u, std::thread::hardware_concurrency()), size_t nQueueMax = 0) {
+			m_stats.nThread = nThread;
+			m_stats.nQueueMax = nQueueMax;
+			m_threads.reserve(nThread);
+			for (size_t i = 0; i < nThread; i++)
+				m_threads.emplace_back([this] { Worker(); });
+		}
+		xThreadPool(xThreadPool const&) = delete;
+		xThreadPool& operator = (xThreadPool const&) = delete;
+		~xThreadPool() {
+			{
+				std::scoped_lock lock{m_mtx};
+				m_bStop = true;
+			}
+			m_cv.notify_all();
+			m_threads.clear();	// join. (remaining jobs are done before)
+		}
+
+		/// @brief default pool (hardware_concurrency threads). created on first use.
+		static xThreadPool& GetDefault() {
+			static xThreadPool pool;
+			return pool;
+		}
+
+		/// @brief queues job. blocks while the queue is full. (not on a driver thread : use RunInPool() there)
+		void Submit(std::function<void()> job) {
+			{
+				std::unique_lock lock{m_mtx};
+				m_cvRoom.wait(lock, [this] { return HasRoom(); });
+				Push(std::move(job));
+			}
+			m_cv.notify_one();
+		}
+		/// @brief queues job if the queue has room.
+		/// @return false if full. (job is left untouched)
+		bool TrySubmit(std::function<void()>& job) {
+			{
+				std::scoped_lock lock{m_mtx};
+				if (!HasRoom()) {
+					m_stats.nRejected++;
+					return false;
+				}
+				Push(std::move(job));
+			}
+			m_cv.notify_one();
+			return true;
+		}
+		/// @brief queues job of a parked sequence. never blocks : if the queue is full, the job waits until a worker makes room.
+		void SubmitParked(std::function<void()> job) {
+			{
+				std::scoped_lock lock{m_mtx};
+				if (!HasRoom()) {
+					m_parked.push_back(std::move(job));
+					m_stats.nParked = m_parked.size();
+					return;
+				}
+				Push(std::move(job));
+			}
+			m_cv.notify_one();
+		}
+
+		sStats GetStats() const {
+			std::scoped_lock lock{m_mtx};
+			return m_stats;
+		}
+		void ResetMaxQueued() {
+			std::scoped_lock lock{m_mtx};
+			m_stats.nQueuedMax = m_stats.nQueued;
+		}
+
+	protected:
+		bool HasRoom() const { return !m_stats.nQueueMax or m_jobs.size() < m_stats.nQueueMax; }
+		void Push(std::function<void()>&& job) {
+			m_jobs.push_back(std::move(job));
+			m_stats.nSubmitted++;
+			m_stats.nQueued = m_jobs.size();
+			m_stats.nQueuedMax = std::max(m_stats.nQueuedMax, m_stats.nQueued);
+		}
+
+		void Worker() {
+			std::unique_lock lock{m_mtx};
+			while (true) {
+				m_cv.wait(lock, [this] { return m_bStop or !m_jobs.empty(); });
+				if (m_jobs.empty())
+					return;	// stop
+				auto job = std::move(m_jobs.front());
+				m_jobs.pop_front();
+				bool const bParked = !m_parked.empty();	// the room goes to parked sequences first
+				if (bParked) {
+					Push(std::move(m_parked.front()));
+					m_parked.pop_front();
+					m_stats.nParked = m_parked.size();
+				}
+				m_stats.nQueued = m_jobs.size();
+				m_stats.nRunning++;
+				lock.unlock();
+				if (bParked)
+					m_cv.notify_one();
+				else if (m_stats.nQueueMax)
+					m_cvRoom.notify_one();
+				job();
+				lock.lock();
+				m_stats.nRunning--;
+				m_stats.nCompleted++;
+			}
+		}
+	};
+
+	//-------------------------------------------------------------------------
+	/// @brief co_await RunInPool(...). runs func on pool thread while the sequence is parked. resumes with return value (or rethrows exception)
+	template < typename tFunc >
+	struct TPoolAwaiter {
+		using value_t = std::invoke_result_t<tFunc>;
+		using storage_t = std::conditional_t<std::is_void_v<value_t>, std::monostate, value_t>;
+		struct sJob {
+			tFunc func;
+			std::optional<storage_t> result;
+			std::exception_ptr exception;
+			std::shared_ptr<sWakeNode> wake;
+		};
+
+		xThreadPool& pool;
+		std::shared_ptr<sJob> job;	// shared with the pool thread. (sequence may be destroyed while running)
+
+		constexpr bool await_ready() const noexcept { return false; }
+		void await_suspend(std::coroutine_handle<>) {
+			// sequence is parked (no ReserveResume) until the job wakes it up.
+			job->wake = sCurrentSequence::GetWakeNode();
+			pool.SubmitParked([job = job] {
+				try {
+					if constexpr (std::is_void_v<value_t>) {
+						job->func();
+						job->result.emplace();
+					}
+					else {
+						job->result.emplace(job->func());
+					}
+				}
+				catch (...) {
+					job->exception = std::current_exception();
+				}
+				job->wake->Wake();
+			});
+		}
+		value_t await_resume() {
+			if (job->exception)
+				std::rethrow_exception(job->exception);
+			if constexpr (!std::is_void_v<value_t>)
+				return std::move(*job->result);
+		}
+	};
+
+}	// namespace gtl::seq::inline v01
@@ -0,0 +1,199 @@
+#pragma once
+
+//////////////////////////////////////////////////////////////////////
+//
+// sequence_profiler.h: suspension point profiler. where sequences wait, and which resumed slices are expensive
+//
+// PWH
+// 2026-10-18
+//
+//////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <functional>
+#include <source_location>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#	include <time.h>
+#endif
+
+#include "sequence_coroutine_handle.h"
+#include "sequence_wake.h"
+
+namespace gtl::seq::inline v01 {
+
+	//-------------------------------------------------------------------------
+	/// @brief suspension point profiler of a driver. (driver.EnableProfiler(), driver thread only)
+	/// awaiters (WaitFor, WaitUntil, Wait, WaitForChild, channels, observables ...) take the location of the co_await. (defaulted std::source_location)
+	/// while enabled, the driver aggregates per location :
+	///		number of suspensions, time suspended (total, percentiles), cpu time of the slice that follows (until the next suspension)
+	/// awaiters without location (co_await future) and the first slice of a sequence are counted as unknown location.
+	/// an awaiter which completes without suspending (ready) drops its location (Unmark()), so it isn't charged with a later suspension.
+	/// disabled : one thread_local load per awaiter.
+	class xSuspendProfiler {
+	public:
+		struct sSite {
+			std::source_location sl;		// empty (line 0) : unknown
+			uint64_t nSuspend{};
+			sDurationHistogram suspended;	// time suspended
+			sDurationHistogram cpu;			// cpu time of the slice after resume
+
+			std::string GetLocation() const {
+				if (!sl.line())
+					return "(unknown)";
+				std::string_view file = sl.file_name();
+				if (auto pos = file.find_last_of("/\\"); pos != file.npos)
+					file.remove_prefix(pos+1);
+				return std::format("{}:{}", file, sl.line());
+			}
+		};
+		enum class eSort : uint8_t { suspended, cpu, count };
+
+		/// @brief current profiler of this thread. set by the driver while dispatching.
+		inline thread_local static xSuspendProfiler* s_current{};
+
+		/// @brief makes profiler current for a scope. (nullptr : none)
+		struct sScope {
+			xSuspendProfiler* old;
+			explicit sScope(xSuspendProfiler* profiler) : old(std::exchange(s_current, profiler)) {}
+			~sScope() { s_current = old; }
+			sScope(sScope const&) = delete;
+			sScope& operator = (sScope const&) = delete;
+		};
+
+	protected:
+		struct sKey {
+			std::string_view file;
+			uint32_t line, column;
+			bool operator == (sKey const&) const = default;
+		};
+		struct sHash {
+			size_t operator () (sKey const& key) const {
+				return std::hash<std::string_view>{}(key.file) ^ ((size_t)key.line << 16) ^ key.column;
+			}
+		};
+		struct sPending {
+			sSite* site;
+			clock_t::time_point tSuspend;
+		};
+		bool m_bEnabled{};
+		std::unordered_map<sKey, sSite, sHash> m_sites;
+		sSite m_unknown;
+		std::unordered_map<void const*, sPending> m_pending;	// suspended sequences
+
+	public:
+		xSuspendProfiler() = default;
+		xSuspendProfiler(xSuspendProfiler const&) = delete;
+		xSuspendProfiler& operator = (xSuspendProfiler const&) = delete;
+
+		bool IsEnabled() const { return m_bEnabled; }
+		void Enable(bool bEnable) {
+			if (!(m_bEnabled = bEnable))
+				m_pending.clear();
+		}
+		void Clear() {
+			m_sites.clear();
+			m_unknown = {};
+			m_pending.clear();
+		}
+
+		/// @brief records suspension point of the current sequence. (called by awaiters)
+		static void Mark(std::source_location const& sl) {
+			if (auto* profiler = s_current) [[unlikely]] {
+				if (sCurrentSequence::s_seq)
+					profiler->Suspend(sCurrentSequence::s_seq, sl);
+			}
+		}
+		/// @brief the awaiter marked last completes without suspending. (await_ready() true, await_suspend() false)
+		static void Unmark() {
+			if (auto* profiler = s_current) [[unlikely]] {
+				if (sCurrentSequence::s_seq)
+					profiler->m_pending.erase(sCurrentSequence::s_seq);
+			}
+		}
+		/// @brief sequence is destroyed
+		static void Forget(void const* seq) {
+			if (auto* profiler = s_current) [[unlikely]]
+				profiler->m_pending.erase(seq);
+		}
+
+		void Suspend(void const* seq, std::source_location const& sl) {
+			auto& site = m_sites[sKey{ sl.file_name(), sl.line(), sl.column() }];
+			if (!site.sl.line())
+				site.sl = sl;
+			m_pending.insert_or_assign(seq, sPending{ &site, clock_t::now() });
+		}
+
+		/// @brief resumes seq, and adds time suspended and cpu time of the slice to the site it was suspended at.
+		void Resume(void const* seq, std::coroutine_handle<> handle) {
+			auto* site = &m_unknown;
+			if (auto node = m_pending.extract(seq)) {
+				site = node.mapped().site;
+				site->suspended.Add(clock_t::now() - node.mapped().tSuspend);
+			}
+			site->nSuspend++;
+			auto const t0 = GetThreadCpuTime();
+			handle.resume();
+			site->cpu.Add(GetThreadCpuTime() - t0);
+			if (!handle.done())
+				m_pending.try_emplace(seq, sPending{ &m_unknown, clock_t::now() });	// suspended at an awaiter without location
+		}
+
+		/// @brief sites sorted by (total time suspended | total cpu time | count), descending. unknown site is included.
+		std::vector<sSite> GetSites(eSort sort = eSort::suspended) const {
+			std::vector<sSite> sites;
+			sites.reserve(m_sites.size()+1);
+			for (auto const& [key, site] : m_sites) {
+				if (site.nSuspend)	// (marked, but never suspended there)
+					sites.push_back(site);
+			}
+			if (m_unknown.nSuspend)
+				sites.push_back(m_unknown);
+			auto value = [sort](sSite const& site) -> int64_t {
+				switch (sort) {
+				case eSort::cpu : return site.cpu.sum.count();
+				case eSort::count : return (int64_t)site.nSuspend;
+				default : return site.suspended.sum.count();
+				}
+			};
+			std::ranges::sort(sites, [&](sSite const& a, sSite const& b) { return value(a) > value(b); });
+			return sites;
+		}
+
+		/// @brief report table. top nTop sites. (times in ms, percentiles are upper bounds of log2 buckets)
+		std::string Report(eSort sort = eSort::suspended, size_t nTop = 30) const {
+			auto ms = [](clock_t::duration d) { return std::chrono::duration<double, std::milli>(d).count(); };
+			auto sites = GetSites(sort);
+			std::string str = std::format("{:<40} {:>9} {:>12} {:>10} {:>10} {:>10} {:>12} {:>10}\n",
+				"location", "count", "suspend ms", "p50", "p99", "max", "cpu ms", "cpu max");
+			for (size_t i = 0; i < sites.size() and i < nTop; i++) {
+				auto const& site = sites[i];
+				str += std::format("{:<40} {:>9} {:>12.3f} {:>10.3f} {:>10.3f} {:>10.3f} {:>12.3f} {:>10.3f}\n",
+					site.GetLocation(), site.nSuspend,
+					ms(site.suspended.sum), ms(site.suspended.Percentile(0.5)), ms(site.suspended.Percentile(0.99)), ms(site.suspended.count ? site.suspended.max : clock_t::duration{}),
+					ms(site.cpu.sum), ms(site.cpu.count ? site.cpu.max : clock_t::duration{}));
+			}
+			return str;
+		}
+
+		/// @brief cpu time of this thread. (wall clock if not supported)
+		static clock_t::duration GetThreadCpuTime() {
+		#if defined(__linux__)
+			timespec ts{};
+			clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+			return std::chrono::duration_cast<clock_t::duration>(std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec));
+		#else
+			return clock_t::now().time_since_epoch();
+		#endif
+		}
+	};
+
+}	// namespace gtl::seq::inline v01
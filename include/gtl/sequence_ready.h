@@ -0,0 +1,166 @@
+#pragma once
+
+//////////////////////////////////////////////////////////////////////
+//
+// sequence_ready.h: ready heap of a driver. flat schedule of a sequence tree
+//
+// PWH
+// 2026-10-18
+//
+//////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "sequence_coroutine_handle.h"
+
+namespace gtl::seq::inline v01 {
+
+	//-------------------------------------------------------------------------
+	/// @brief ready heap of a driver. (owned by the top most sequence, driver thread only)
+	/// holds every sequence which can be resumed by time : no children, not done, next dispatch time is not max (parked).
+	/// ordered by (next dispatch time, order of reservation). sequences reserved for the same time are resumed in FIFO order.
+	/// each sequence keeps its position (m_iReady), so rescheduling and removal are O(log n).
+	/// the driver pops due sequences instead of walking the tree. the cost of a tick does not depend on the depth of the tree.
+	/// parents are not in the heap. a parent is resumed when its last child is done. (finished, swept by the driver)
+	template < typename tSequence >
+	class TReadyHeap {
+	public:
+		using seq_t = tSequence;
+		static constexpr uint32_t npos = (uint32_t)-1;
+
+	protected:
+		struct sEntry {
+			clock_t::time_point t;	// copy of seq->m_tNextDispatch
+			uint64_t order;
+			seq_t* seq;
+			bool operator < (sEntry const& b) const { return t < b.t or (t == b.t and order < b.order); }
+		};
+		std::vector<sEntry> m_heap;
+		uint64_t m_order{};
+		std::vector<uint32_t> m_stack;	// NextDispatchLatest()
+
+	public:
+		/// @brief parents having finished children. (to be swept by the driver)
+		std::vector<seq_t*> finished;
+
+	public:
+		TReadyHeap() = default;
+		TReadyHeap(TReadyHeap const&) = delete;
+		TReadyHeap& operator = (TReadyHeap const&) = delete;
+
+		size_t size() const { return m_heap.size(); }
+		bool empty() const { return m_heap.empty(); }
+
+		/// @brief earliest next dispatch time. max if empty
+		clock_t::time_point NextDispatch() const { return m_heap.empty() ? clock_t::time_point::max() : m_heap.front().t; }
+
+		/// @brief earliest (next dispatch time + slack). (coalesced wake-up time of the driver)
+		/// only sequences due before the earliest 'latest' time can make it earlier, so the search is bounded by the coalescing window.
+		clock_t::time_point NextDispatchLatest() {
+			auto tLatest = clock_t::time_point::max();
+			if (m_heap.empty())
+				return tLatest;
+			m_stack.clear();
+			m_stack.push_back(0);
+			while (!m_stack.empty()) {
+				auto const i = m_stack.back();
+				m_stack.pop_back();
+				auto const& entry = m_heap[i];
+				if (entry.t >= tLatest)
+					continue;	// so are its descendants
+				tLatest = std::min(tLatest, entry.seq->m_tNextDispatchLatest);
+				if (auto c = 2*i+1; c < m_heap.size())
+					m_stack.push_back(c);
+				if (auto c = 2*i+2; c < m_heap.size())
+					m_stack.push_back(c);
+			}
+			return tLatest;
+		}
+
+		/// @brief inserts seq, or moves it to its new next dispatch time. (seq->m_tNextDispatch)
+		void Push(seq_t& seq) {
+			if (seq.m_iReady == npos) {
+				seq.m_iReady = (uint32_t)m_heap.size();
+				m_heap.push_back(sEntry{ seq.m_tNextDispatch, m_order++, &seq });
+				SiftUp(seq.m_iReady);
+				return;
+			}
+			auto const i = seq.m_iReady;
+			auto const old = m_heap[i];
+			m_heap[i].t = seq.m_tNextDispatch;
+			m_heap[i].order = m_order++;
+			if (m_heap[i] < old)
+				SiftUp(i);
+			else
+				SiftDown(i);
+		}
+		void Remove(seq_t& seq) {
+			auto const i = std::exchange(seq.m_iReady, npos);
+			if (i == npos)
+				return;
+			auto const last = (uint32_t)m_heap.size() - 1;
+			if (i != last) {
+				auto const old = m_heap[i];
+				Place(i, m_heap[last]);
+				m_heap.pop_back();
+				if (m_heap[i] < old)
+					SiftUp(i);
+				else
+					SiftDown(i);
+			}
+			else
+				m_heap.pop_back();
+		}
+		/// @brief takes the earliest sequence if it is due
+		/// @return nullptr if none is due
+		seq_t* PopDue(clock_t::time_point now) {
+			if (m_heap.empty() or m_heap.front().t > now)
+				return nullptr;
+			auto* seq = m_heap.front().seq;
+			Remove(*seq);
+			return seq;
+		}
+		/// @brief seq has been moved to another object
+		void Relocate(seq_t& seq) {
+			if (seq.m_iReady != npos)
+				m_heap[seq.m_iReady].seq = &seq;
+		}
+
+	protected:
+		void Place(uint32_t i, sEntry const& entry) {
+			m_heap[i] = entry;
+			entry.seq->m_iReady = i;
+		}
+		void SiftUp(uint32_t i) {
+			auto const entry = m_heap[i];
+			while (i) {
+				auto const parent = (i-1)/2;
+				if (!(entry < m_heap[parent]))
+					break;
+				Place(i, m_heap[parent]);
+				i = parent;
+			}
+			Place(i, entry);
+		}
+		void SiftDown(uint32_t i) {
+			auto const entry = m_heap[i];
+			auto const n = (uint32_t)m_heap.size();
+			while (true) {
+				auto c = 2*i+1;
+				if (c >= n)
+					break;
+				if (c+1 < n and m_heap[c+1] < m_heap[c])
+					c++;
+				if (!(m_heap[c] < entry))
+					break;
+				Place(i, m_heap[c]);
+				i = c;
+			}
+			Place(i, entry);
+		}
+	};
+
+}	// namespace gtl::seq::inline v01
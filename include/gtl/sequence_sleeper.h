@@ -0,0 +1,268 @@
+#pragma once
+
+//////////////////////////////////////////////////////////////////////
+//
+// sequence_sleeper.h: sleepers for the dispatch loop (plain, hybrid sleep/spin)
+//
+// PWH
+// 2026-10-18
+//
+//////////////////////////////////////////////////////////////////////
+
+#include <array>
+#include <atomic>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#if defined(_MSC_VER)
+#	include <intrin.h>
+#endif
+#if defined(__linux__)
+#	include <poll.h>
+#	include <unistd.h>
+#	include <sys/eventfd.h>
+#	include <sys/prctl.h>
+#	include <sys/timerfd.h>
+#endif
+
+#include "sequence_coroutine_handle.h"
+
+namespace gtl::seq::inline v01 {
+
+#if defined(__linux__)
+	//-------------------------------------------------------------------------
+	/// @brief clock_t may not be monotonic. converts to CLOCK_MONOTONIC absolute time (for timerfd, clock_nanosleep)
+	inline timespec ToMonotonicTimespec(clock_t::time_point t) {
+		timespec now{};
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		auto const rel = std::chrono::duration_cast<std::chrono::nanoseconds>(t - clock_t::now()).count();
+		auto const abs = (int64_t)now.tv_sec * 1'000'000'000 + now.tv_nsec + std::max<int64_t>(rel, 1);
+		return { .tv_sec = abs / 1'000'000'000, .tv_nsec = abs % 1'000'000'000 };
+	}
+#endif
+
+	//-------------------------------------------------------------------------
+	/// @brief wake-up jitter histogram (actual wake-up time - requested time).
+	using sJitterHistogram = sDurationHistogram;
+
+	//-------------------------------------------------------------------------
+	/// @brief plain sleeper. sleeps until given time or until interrupted. (accuracy depends on the OS scheduler)
+	class xSleeper {
+	protected:
+		std::mutex m_mtx;
+		std::condition_variable m_cv;
+		bool m_bInterrupted{};
+
+	public:
+		/// @brief sleep until t. returns earlier if Interrupt() is called.
+		void SleepUntil(clock_t::time_point t) {
+			std::unique_lock lock{m_mtx};
+			if (t == clock_t::time_point::max())
+				m_cv.wait(lock, [this] { return m_bInterrupted; });
+			else
+				m_cv.wait_until(lock, t, [this] { return m_bInterrupted; });
+			m_bInterrupted = false;
+		}
+		/// @brief wakes up sleeping thread. can be called from any thread.
+		void Interrupt() {
+			{
+				std::scoped_lock lock{m_mtx};
+				m_bInterrupted = true;
+			}
+			m_cv.notify_one();
+		}
+	};
+
+	//-------------------------------------------------------------------------
+	/// @brief hybrid sleeper. sleeps with high resolution kernel timer until (t - spin window), and spins for the rest.
+	/// spin window is calibrated from the measured kernel wake-up error.
+	/// Linux : timerfd (CLOCK_MONOTONIC, absolute) + eventfd (for Interrupt()). others : condition variable.
+	class xHybridSleeper {
+	public:
+		struct sOption {
+			clock_t::duration spinMin{std::chrono::microseconds(2)};
+			clock_t::duration spinMax{std::chrono::milliseconds(2)};
+			clock_t::duration spinInitial{std::chrono::microseconds(200)};
+			double gain{4.0};		// spin window = mean(error) + gain * deviation(error)
+			double alpha{0.1};		// EWMA weight of new sample
+			bool bCalibrate{true};
+			bool bMinimizeTimerSlack{true};	// Linux : prctl(PR_SET_TIMERSLACK, 1) for the sleeping thread
+		};
+
+	protected:
+		sOption m_option;
+		std::atomic<clock_t::duration> m_spin;	// (read by GetSpinWindow() from other threads)
+		double m_errMean{}, m_errDev{};	// kernel wake-up error (ns)
+		std::atomic<bool> m_bInterrupted{};
+
+		mutable std::mutex m_mtxHistogram;
+		sJitterHistogram m_histogram;
+
+	#if defined(__linux__)
+		int m_fdTimer{-1};
+		int m_fdEvent{-1};
+		std::thread::id m_threadSlack{};
+	#else
+		std::mutex m_mtx;
+		std::condition_variable m_cv;
+	#endif
+
+	public:
+		xHybridSleeper() : xHybridSleeper(sOption{}) {}
+		explicit xHybridSleeper(sOption option) : m_option(option), m_spin(option.spinInitial) {
+		#if defined(__linux__)
+			m_fdTimer = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC|TFD_NONBLOCK);
+			m_fdEvent = eventfd(0, EFD_CLOEXEC|EFD_NONBLOCK);
+			if (m_fdTimer < 0 or m_fdEvent < 0) {
+				Close();
+				throw xException("xHybridSleeper() : cannot create timerfd/eventfd");
+			}
+		#endif
+		}
+		xHybridSleeper(xHybridSleeper const&) = delete;
+		xHybridSleeper& operator = (xHybridSleeper const&) = delete;
+		~xHybridSleeper() {
+		#if defined(__linux__)
+			Close();
+		#endif
+		}
+
+		/// @brief sleep until t. returns earlier if Interrupt() is called.
+		void SleepUntil(clock_t::time_point t) {
+			if (ConsumeInterrupt())
+				return;
+
+			// kernel sleep
+			auto const spin = m_spin.load(std::memory_order_relaxed);
+			if (auto tWake = (t == clock_t::time_point::max()) ? t : t - spin; clock_t::now() < tWake) {
+				if (!KernelSleepUntil(tWake))
+					return;	// interrupted
+				if (t == clock_t::time_point::max())
+					return;
+				if (m_option.bCalibrate)
+					Calibrate(clock_t::now() - tWake);
+			}
+
+			// spin
+			auto tNow = clock_t::now();
+			while (tNow < t) {
+				if (ConsumeInterrupt())
+					return;
+				CpuRelax();
+				tNow = clock_t::now();
+			}
+
+			std::scoped_lock lock{m_mtxHistogram};
+			m_histogram.Add(tNow - t);
+		}
+
+		/// @brief wakes up sleeping thread. can be called from any thread.
+		void Interrupt() {
+		#if defined(__linux__)
+			// eventfd first : whoever consumes the flag also finds the eventfd set, and drains it
+			uint64_t v = 1;
+			[[maybe_unused]] auto r = write(m_fdEvent, &v, sizeof(v));
+			m_bInterrupted = true;
+		#else
+			m_bInterrupted = true;
+			{ std::scoped_lock lock{m_mtx}; }
+			m_cv.notify_one();
+		#endif
+		}
+
+		//-----------------------------------
+		auto const& GetOption() const { return m_option; }
+		clock_t::duration GetSpinWindow() const { return m_spin.load(std::memory_order_relaxed); }
+		sJitterHistogram GetJitterHistogram() const {
+			std::scoped_lock lock{m_mtxHistogram};
+			return m_histogram;
+		}
+		void ResetJitterHistogram() {
+			std::scoped_lock lock{m_mtxHistogram};
+			m_histogram.Clear();
+		}
+
+	protected:
+		static inline void CpuRelax() {
+		#if defined(_MSC_VER) and (defined(_M_X64) or defined(_M_IX86))
+			_mm_pause();
+		#elif defined(__x86_64__) or defined(__i386__)
+			__builtin_ia32_pause();
+		#elif defined(__aarch64__)
+			asm volatile("yield");
+		#else
+			std::this_thread::yield();
+		#endif
+		}
+
+		void Calibrate(clock_t::duration err) {
+			double const e = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(err).count();
+			m_errMean += m_option.alpha * (e - m_errMean);
+			m_errDev += m_option.alpha * (std::abs(e - m_errMean) - m_errDev);
+			auto const spin = std::chrono::nanoseconds((int64_t)(m_errMean + m_option.gain * m_errDev));
+			m_spin.store(std::clamp<clock_t::duration>(spin, m_option.spinMin, m_option.spinMax), std::memory_order_relaxed);
+		}
+
+		/// @brief takes pending Interrupt(). the eventfd is drained with it, so it doesn't wake up the next sleep.
+		/// @return true if interrupted
+		bool ConsumeInterrupt() {
+			if (!m_bInterrupted.exchange(false))
+				return false;
+		#if defined(__linux__)
+			uint64_t v{};
+			[[maybe_unused]] auto r = read(m_fdEvent, &v, sizeof(v));	// (non-blocking)
+		#endif
+			return true;
+		}
+
+		/// @return false if interrupted
+	#if defined(__linux__)
+		bool KernelSleepUntil(clock_t::time_point t) {
+			if (m_option.bMinimizeTimerSlack and m_threadSlack != std::this_thread::get_id()) {
+				m_threadSlack = std::this_thread::get_id();
+				prctl(PR_SET_TIMERSLACK, 1UL, 0, 0, 0);
+			}
+
+			itimerspec spec{};
+			if (t != clock_t::time_point::max())
+				spec.it_value = ToMonotonicTimespec(t);
+			timerfd_settime(m_fdTimer, TFD_TIMER_ABSTIME, &spec, nullptr);	// zero it_value disarms timer
+
+			pollfd fds[2] = { {m_fdTimer, POLLIN, 0}, {m_fdEvent, POLLIN, 0} };
+			while (true) {
+				if (poll(fds, 2, -1) < 0)
+					continue;	// EINTR
+				uint64_t v{};
+				if (fds[1].revents & POLLIN) {
+					[[maybe_unused]] auto r = read(m_fdEvent, &v, sizeof(v));
+					m_bInterrupted = false;
+					return false;
+				}
+				if (fds[0].revents & POLLIN) {
+					[[maybe_unused]] auto r = read(m_fdTimer, &v, sizeof(v));
+					return true;
+				}
+			}
+		}
+		void Close() {
+			if (m_fdTimer >= 0) close(std::exchange(m_fdTimer, -1));
+			if (m_fdEvent >= 0) close(std::exchange(m_fdEvent, -1));
+		}
+	#else
+		bool KernelSleepUntil(clock_t::time_point t) {
+			std::unique_lock lock{m_mtx};
+			auto pred = [this] { return m_bInterrupted.load(); };
+			bool bInterrupted = (t == clock_t::time_point::max()) ? (m_cv.wait(lock, pred), true) : m_cv.wait_until(lock, t, pred);
+			if (bInterrupted)
+				m_bInterrupted = false;
+			return !bInterrupted;
+		}
+	#endif
+	};
+
+}	// namespace gtl::seq::inline v01
@@ -0,0 +1,171 @@
+#pragma once
+
+//////////////////////////////////////////////////////////////////////
+//
+// sequence_snapshot.h: read-only snapshot of a sequence tree for monitoring threads. (published by the driver, RCU)
+//
+// PWH
+// 2026-10-18
+//
+//////////////////////////////////////////////////////////////////////
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "sequence_coroutine_handle.h"
+
+namespace gtl::seq::inline v01 {
+
+	//-------------------------------------------------------------------------
+	/// @brief immutable snapshot of a sequence tree. built on the driver thread, shared by any number of readers.
+	/// nodes are stored in pre-order (depth first). nodes[0] is the sequence the snapshot was taken from. (driver)
+	/// a subtree is contiguous : descendants of nodes[i] are nodes[i+1 .. i+nDescendant].
+	struct sSequenceSnapshot {
+		enum class eState : uint8_t {
+			ready,		// due. will be resumed at next Dispatch()
+			sleeping,	// WaitFor/WaitUntil. (tNextDispatch)
+			parked,		// waiting for wake-up. (future, channel, stream, pool, i/o ...)
+			predicate,	// Wait(pred)
+			children,	// waiting for child sequences
+			done,
+		};
+		static constexpr size_t nStates = (size_t)eState::done + 1;
+		static constexpr uint32_t npos = (uint32_t)-1;
+
+		struct sNode {
+			seq_id_t name;
+			uint32_t parent{npos};
+			uint32_t depth{};
+			uint32_t nChild{};
+			uint32_t nDescendant{};
+			eState state{};
+			clock_t::time_point tNextDispatch{};		// of children, if it has children
+			clock_t::time_point tNextDispatchLatest{};	// + slack
+			uint64_t nResume{};	// number of resumes. (counted for sequences having cold data : named, parents, ...)
+		};
+
+		std::vector<sNode> nodes;
+		uint64_t generation{};			// incremented on every publish
+		clock_t::time_point tTaken{};
+		clock_t::duration durBuild{};	// time spent by the driver to build this snapshot
+		std::array<size_t, nStates> nState{};	// number of sequences per state
+
+		size_t size() const { return nodes.size(); }
+		bool empty() const { return nodes.empty(); }
+		sNode const& operator [] (size_t index) const { return nodes[index]; }
+		uint32_t IndexOf(sNode const& node) const { return (uint32_t)(&node - nodes.data()); }
+		size_t Count(eState state) const { return nState[(size_t)state]; }
+
+		/// @brief calls func(node) for each direct child of nodes[index]
+		template < typename tFunc >
+		void ForEachChild(uint32_t index, tFunc&& func) const {
+			auto const end = index + nodes[index].nDescendant + 1;
+			for (auto i = index + 1; i < end; i += nodes[i].nDescendant + 1)
+				func(nodes[i]);
+		}
+
+		/// @brief direct child of nodes[index]
+		sNode const* FindDirectChild(seq_id_t const& name, uint32_t index = 0) const {
+			if (index >= nodes.size())
+				return nullptr;
+			sNode const* found{};
+			ForEachChild(index, [&](sNode const& node) {
+				if (!found and node.name == name)
+					found = &node;
+			});
+			return found;
+		}
+		/// @brief descendant of nodes[index] (depth first)
+		sNode const* FindChildDFS(seq_id_t const& name, uint32_t index = 0) const {
+			if (index >= nodes.size())
+				return nullptr;
+			auto const end = index + nodes[index].nDescendant + 1;
+			for (auto i = index + 1; i < end; i++) {
+				if (nodes[i].name == name)
+					return &nodes[i];
+			}
+			return nullptr;
+		}
+
+		/// @brief names from the root. ex) "driver/unit/job"
+		seq_id_t GetPath(uint32_t index, char delimiter = '/') const {
+			seq_id_t path;
+			for (auto i = index; i != npos; i = nodes[i].parent) {
+				path.insert(0, nodes[i].name);
+				if (nodes[i].parent != npos)
+					path.insert(path.begin(), delimiter);
+			}
+			return path;
+		}
+
+		void Clear() {
+			nodes.clear();	// keeps capacity (reused by the driver)
+			nState = {};
+		}
+	};
+
+	//-------------------------------------------------------------------------
+	/// @brief publishes snapshots of a driver. (read-copy-update)
+	/// the driver builds a new snapshot off to the side and swaps it in. readers hold their own reference, so they never see a half built snapshot,
+	/// and the driver never waits for readers. a snapshot nobody holds any more is reused by the driver (double buffer, no allocation in steady state).
+	class xSnapshotBoard {
+	public:
+		using snapshot_t = sSequenceSnapshot;
+
+	protected:
+		std::atomic<std::shared_ptr<snapshot_t const>> m_snapshot;
+		std::shared_ptr<snapshot_t> m_spare;	// driver only
+		uint64_t m_generation{};
+		clock_t::duration m_interval{};
+		clock_t::time_point m_tNext{};
+
+	public:
+		/// @brief called on the driver thread with every published snapshot. (ex, exporter. sequence_status_table.h)
+		std::function<void(snapshot_t const&)> fnPublished;
+
+		explicit xSnapshotBoard(clock_t::duration interval = {}) : m_interval(interval) {}
+		xSnapshotBoard(xSnapshotBoard const&) = delete;
+		xSnapshotBoard& operator = (xSnapshotBoard const&) = delete;
+
+		/// @brief latest snapshot. any thread. nullptr if nothing published yet
+		std::shared_ptr<snapshot_t const> Get() const { return m_snapshot.load(std::memory_order_acquire); }
+
+		//-----------------------------------
+		// driver side
+
+		/// @brief interval of automatic publish at the end of Dispatch(). 0 : every tick. max : on demand only (PublishSnapshot())
+		void SetInterval(clock_t::duration interval) { m_interval = interval; m_tNext = {}; }
+		auto GetInterval() const { return m_interval; }
+		bool IsDue(clock_t::time_point now) const { return m_interval != clock_t::duration::max() and now >= m_tNext; }
+
+		/// @brief empty snapshot to fill. (reuses the one no reader holds)
+		std::shared_ptr<snapshot_t> Prepare() {
+			auto snapshot = std::exchange(m_spare, nullptr);
+			if (!snapshot)
+				snapshot = std::make_shared<snapshot_t>();
+			snapshot->Clear();
+			return snapshot;
+		}
+		void Publish(std::shared_ptr<snapshot_t> snapshot, clock_t::time_point now) {
+			snapshot->generation = ++m_generation;
+			if (m_interval != clock_t::duration::max())
+				m_tNext = now + m_interval;
+			if (fnPublished)
+				fnPublished(*snapshot);
+			auto old = m_snapshot.exchange(std::move(snapshot), std::memory_order_acq_rel);
+			// readers got their reference before the exchange. if no one holds it now, no one will.
+			if (old and old.use_count() == 1) {
+				std::atomic_thread_fence(std::memory_order_acquire);	// pairs with the release of readers' last reference
+				m_spare = std::const_pointer_cast<snapshot_t>(std::move(old));
+			}
+		}
+	};
+
+}	// namespace gtl::seq::inline v01
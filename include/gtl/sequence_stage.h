@@ -0,0 +1,158 @@
+#pragma once
+
+//////////////////////////////////////////////////////////////////////
+//
+// sequence_stage.h: pre/post dispatch stages of a driver, and process image (batched i/o per tick)
+//
+// PWH
+// 2026-10-18
+//
+//////////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <utility>
+#include <variant>
+
+#include "sequence_coroutine_handle.h"
+
+namespace gtl::seq::inline v01 {
+
+	enum class eDispatchStage : uint8_t {
+		pre,	// before any sequence is resumed. (ex, reads all inputs at once)
+		post,	// after all due sequences are resumed. (ex, writes all outputs at once)
+	};
+
+	//-------------------------------------------------------------------------
+	/// @brief stage functions of a driver. each one runs once per Dispatch(), on the driver thread. (owned by the top most sequence)
+	class xDispatchStages {
+	protected:
+		struct sStage {
+			uint64_t id{};
+			std::function<void()> func;
+			bool bRemoved{};	// erased after Run(). (a stage may remove itself)
+		};
+		std::deque<sStage> m_stages[2];	// (no reallocation while a stage function is running)
+		uint64_t m_id{};
+		bool m_bRemoved{};
+
+	public:
+		xDispatchStages() = default;
+		xDispatchStages(xDispatchStages const&) = delete;
+		xDispatchStages& operator = (xDispatchStages const&) = delete;
+
+		/// @return id for Remove()
+		uint64_t Add(eDispatchStage stage, std::function<void()> func) {
+			if (!func)
+				throw xException("xDispatchStages::Add() : empty function");
+			auto const id = ++m_id;
+			m_stages[(int)stage].push_back(sStage{ id, std::move(func) });
+			return id;
+		}
+		/// @brief removes a stage. can be called from a stage function.
+		bool Remove(uint64_t id) {
+			for (auto& stages : m_stages) {
+				for (auto& stage : stages) {
+					if (stage.id != id or stage.bRemoved)
+						continue;
+					stage.bRemoved = true;
+					m_bRemoved = true;
+					return true;
+				}
+			}
+			return false;
+		}
+
+		/// @brief runs stage functions in the order of registration
+		void Run(eDispatchStage stage) {
+			auto& stages = m_stages[(int)stage];
+			for (size_t i = 0, n = stages.size(); i < n; i++) {	// stages added while running start from the next tick
+				if (!stages[i].bRemoved)
+					stages[i].func();
+			}
+			if (std::exchange(m_bRemoved, false)) {
+				for (auto& s : m_stages)
+					std::erase_if(s, [](sStage const& stage) { return stage.bRemoved; });
+			}
+		}
+	};
+
+	//-------------------------------------------------------------------------
+	/// @brief process image of a driver. inputs are read once per tick (pre stage), outputs are written once per tick (post stage) if changed.
+	/// sequences read In() and write Out() on the driver thread, without lock and without i/o.
+	/// N small reads/writes of N sequences become one batched read and one batched write per tick.
+	///		TProcessImage<sInputs, sOutputs> image;
+	///		image.Attach(driver, [&](sInputs& in) { bus.ReadAll(in); }, [&](sOutputs const& out) { bus.WriteAll(out); });
+	///		co_await seq.Wait([&] { return image.In().bDoorClosed; }, 1ms);
+	///		image.Out().bLamp = true;
+	/// the driver must outlive the image. the image detaches itself when destroyed.
+	template < typename tInputs, typename tOutputs = std::monostate >
+	class TProcessImage {
+	public:
+		using inputs_t = tInputs;
+		using outputs_t = tOutputs;
+		using fnRead_t = std::function<void(tInputs&)>;
+		using fnWrite_t = std::function<void(tOutputs const&)>;
+
+	protected:
+		tInputs m_inputs{};
+		tOutputs m_outputs{};
+		bool m_bDirty{};
+		uint64_t m_tick{};
+		fnRead_t m_fnRead;
+		fnWrite_t m_fnWrite;
+		uint64_t m_idPre{}, m_idPost{};
+		std::function<bool(uint64_t)> m_fnRemove;	// RemoveDispatchStage() of the attached driver
+
+	public:
+		TProcessImage() = default;
+		TProcessImage(TProcessImage const&) = delete;
+		TProcessImage& operator = (TProcessImage const&) = delete;
+		~TProcessImage() { Detach(); }
+
+		/// @brief inputs of this tick
+		tInputs const& In() const { return m_inputs; }
+		/// @brief outputs. written at the end of this tick
+		tOutputs& Out() { m_bDirty = true; return m_outputs; }
+		tOutputs const& GetOutputs() const { return m_outputs; }
+		/// @brief number of input reads. (ticks)
+		uint64_t GetTick() const { return m_tick; }
+
+		/// @brief registers read (pre stage) and write (post stage) to the driver. (driver thread)
+		/// fnWrite is called only if Out() was accessed in the tick.
+		/// attaching again detaches from the previous driver first.
+		template < typename tSequence >
+		void Attach(tSequence& driver, fnRead_t fnRead, fnWrite_t fnWrite = {}) {
+			Detach();
+			m_fnRead = std::move(fnRead);
+			m_fnWrite = std::move(fnWrite);
+			m_fnRemove = [&driver](uint64_t id) { return driver.RemoveDispatchStage(id); };
+			if (m_fnRead)
+				m_idPre = driver.AddDispatchStage(eDispatchStage::pre, [this] { Read(); });
+			if (m_fnWrite)
+				m_idPost = driver.AddDispatchStage(eDispatchStage::post, [this] { Flush(); });
+		}
+		/// @brief removes stage functions from the attached driver. (driver thread)
+		void Detach() {
+			auto fnRemove = std::exchange(m_fnRemove, nullptr);
+			if (!fnRemove)
+				return;
+			if (auto id = std::exchange(m_idPre, 0))
+				fnRemove(id);
+			if (auto id = std::exchange(m_idPost, 0))
+				fnRemove(id);
+		}
+		bool IsAttached() const { return (bool)m_fnRemove; }
+
+		void Read() {
+			m_fnRead(m_inputs);
+			m_tick++;
+		}
+		void Flush() {
+			if (std::exchange(m_bDirty, false))
+				m_fnWrite(m_outputs);
+		}
+	};
+
+}	// namespace gtl::seq::inline v01
@@ -0,0 +1,379 @@
+#pragma once
+
+//////////////////////////////////////////////////////////////////////
+//
+// sequence_status_table.h: status table of a sequence tree in POSIX shared memory. (out-of-process monitoring)
+//
+// PWH
+// 2026-10-18
+//
+//////////////////////////////////////////////////////////////////////
+
+#if defined(_WIN32)
+#	error "sequence_status_table.h : POSIX only (shm_open, mmap)"
+#endif
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "sequence_snapshot.h"
+
+namespace gtl::seq::inline v01 {
+
+	//-------------------------------------------------------------------------
+	// layout. (fixed. readers check magic, version and sizes)
+	//	[sStatusTableHeader : 192 bytes][sStatusSlot : 128 bytes] x capacity
+	// every record is guarded by its own seqlock. (odd while the driver writes it)
+	// the summary's seqlock stays odd during the whole export, so a reader can sample all records consistently. (Sample())
+	// times are nanoseconds since the epoch of clock_t. (INT64_MAX : never)
+
+	/// @brief FNV-1a. hash of sequence names in the table
+	constexpr uint64_t HashStatusName(std::string_view name) noexcept {
+		uint64_t h = 0xcbf29ce484222325ull;
+		for (auto c : name) {
+			h ^= (uint8_t)c;
+			h *= 0x100000001b3ull;
+		}
+		return h;
+	}
+
+	/// @brief one sequence
+	struct sStatusRecord {
+		static constexpr uint32_t npos = sSequenceSnapshot::npos;
+
+		uint32_t parent{npos};	// slot index
+		uint32_t nChild{};
+		uint8_t state{};		// sSequenceSnapshot::eState
+		uint8_t depth{};		// (saturated)
+		uint16_t reserved0{};
+		uint32_t reserved1{};
+		uint64_t nameHash{};	// HashStatusName(full name)
+		int64_t tNextDispatch{};
+		int64_t tNextDispatchLatest{};
+		uint64_t nResume{};
+		char name[72]{};		// truncated. zero terminated
+
+		std::string_view GetName() const { return { name, strnlen(name, sizeof(name)) }; }
+		auto GetState() const { return (sSequenceSnapshot::eState)state; }
+		bool operator == (sStatusRecord const&) const = default;
+	};
+	static_assert(sizeof(sStatusRecord) == 120 and std::is_trivially_copyable_v<sStatusRecord>);
+
+	/// @brief table-wide values
+	struct sStatusSummary {
+		uint32_t nSlot{};		// number of used slots
+		uint32_t pid{};			// exporter
+		uint64_t generation{};	// snapshot generation
+		int64_t tExported{};
+		int64_t durBuild{};		// time spent by the driver to build the snapshot
+		std::array<uint64_t, sSequenceSnapshot::nStates> nState{};
+		uint64_t nOverflow{};	// sequences not exported. (capacity)
+		bool operator == (sStatusSummary const&) const = default;
+	};
+	static_assert(std::is_trivially_copyable_v<sStatusSummary> and sizeof(sStatusSummary) % 8 == 0);
+
+	/// @brief seqlock guarded T. accessed word by word with atomics, so it can be shared between processes.
+	template < typename T >
+	struct alignas(64) TSeqLocked {
+		static constexpr size_t nWord = sizeof(T) / sizeof(uint64_t);
+		using words_t = std::array<uint64_t, nWord>;
+		static_assert(sizeof(T) % sizeof(uint64_t) == 0 and std::atomic<uint64_t>::is_always_lock_free);
+
+		static constexpr uint32_t s_nRetry = 10'000;	// of readers. (a writer which died in the middle never finishes)
+
+		std::atomic<uint64_t> seq;
+		words_t words;
+
+		/// @brief single writer
+		void Store(T const& value) {
+			BeginStore();
+			EndStore(value);
+		}
+		/// @brief single writer. readers retry from now until EndStore(), so the writer can cover other data written in between. (LoadWith())
+		void BeginStore() {
+			seq.store(seq.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+		}
+		void EndStore(T const& value) {
+			auto const w = std::bit_cast<words_t>(value);
+			for (size_t i = 0; i < nWord; i++)
+				std::atomic_ref<uint64_t>(words[i]).store(w[i], std::memory_order_relaxed);
+			seq.store(seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+		}
+
+		/// @brief any number of readers. retries while the writer is in the middle, up to nRetry times.
+		/// @return nullopt if the writer didn't finish. (ex, the exporter died while writing)
+		std::optional<T> Load(uint32_t nRetry = s_nRetry) const {
+			return LoadWith([](T const&) { return true; }, nRetry);
+		}
+		/// @brief loads value, and whatever func(value) reads of the data the writer covers with BeginStore() / EndStore(), consistently.
+		/// func returns false to retry.
+		template < typename tFunc >
+		std::optional<T> LoadWith(tFunc&& func, uint32_t nRetry = s_nRetry) const {
+			words_t w;
+			for (uint32_t iTry = 0; iTry <= nRetry; iTry++) {
+				auto const s0 = seq.load(std::memory_order_acquire);
+				if (s0 & 1) {
+					std::this_thread::yield();
+					continue;
+				}
+				for (size_t i = 0; i < nWord; i++)
+					w[i] = std::atomic_ref<uint64_t>(const_cast<uint64_t&>(words[i])).load(std::memory_order_relaxed);	// (read-only mapping : load only)
+				bool const bRead = func(std::bit_cast<T>(w));
+				std::atomic_thread_fence(std::memory_order_acquire);
+				if (bRead and seq.load(std::memory_order_relaxed) == s0)
+					return std::bit_cast<T>(w);
+			}
+			return std::nullopt;
+		}
+	};
+
+	struct sStatusTableHeader {
+		static constexpr char s_magic[8] = { 'G', 'T', 'L', 'S', 'E', 'Q', 'S', 'T' };
+		static constexpr uint32_t s_version = 2;
+
+		char magic[8];
+		uint32_t version;
+		uint32_t headerSize;
+		uint32_t slotSize;
+		uint32_t capacity;
+		uint32_t pid;	// exporter. (a table of a dead exporter is replaced by the next one)
+		alignas(64) TSeqLocked<sStatusSummary> summary;
+	};
+	using sStatusSlot = TSeqLocked<sStatusRecord>;
+	static_assert(sizeof(sStatusTableHeader) == 192 and sizeof(sStatusSlot) == 128);
+
+	//-------------------------------------------------------------------------
+	/// @brief exporter. owns the shared memory. written by the driver thread only.
+	///		xStatusTable table("/my_controller", 4096);
+	///		driver.SetSnapshotHandler([&table](auto const& snapshot) { table.Export(snapshot); });
+	///		driver.EnableSnapshot(100ms);
+	/// no system call after construction. only changed records are rewritten.
+	/// one exporter per name : construction fails if the table is owned by a running process. (a table left by a dead one is replaced)
+	class xStatusTable {
+	protected:
+		std::string m_name;
+		int m_fd{-1};
+		void* m_base{};
+		size_t m_size{};
+		bool m_bUnlink{};
+		std::vector<sStatusRecord> m_last;	// last exported. (skips unchanged slots)
+
+	public:
+		/// @param name shm object name. ("/name")
+		/// @param capacity max number of sequences
+		/// @param bUnlink removes the shm object on destruction
+		xStatusTable(std::string name, uint32_t capacity, bool bUnlink = true) : m_name(std::move(name)), m_bUnlink(bUnlink) {
+			m_size = sizeof(sStatusTableHeader) + (size_t)capacity * sizeof(sStatusSlot);
+			m_fd = shm_open(m_name.c_str(), O_CREAT|O_EXCL|O_RDWR, 0644);
+			if (m_fd < 0 and errno == EEXIST and IsStale(m_name)) {
+				shm_unlink(m_name.c_str());
+				m_fd = shm_open(m_name.c_str(), O_CREAT|O_EXCL|O_RDWR, 0644);
+			}
+			if (m_fd < 0) {
+				auto const err = errno;
+				throw xException("xStatusTable : shm_open() failed. " + std::string(strerror(err)) + (err == EEXIST ? ". (exported by other process)" : ""));
+			}
+			if (ftruncate(m_fd, (off_t)m_size) < 0) {	// (zero filled)
+				Close();
+				throw xException("xStatusTable : ftruncate() failed. " + std::string(strerror(errno)));
+			}
+			m_base = mmap(nullptr, m_size, PROT_READ|PROT_WRITE, MAP_SHARED, m_fd, 0);
+			if (m_base == MAP_FAILED) {
+				m_base = nullptr;
+				Close();
+				throw xException("xStatusTable : mmap() failed. " + std::string(strerror(errno)));
+			}
+			auto& header = Header();
+			header.version = sStatusTableHeader::s_version;
+			header.headerSize = sizeof(sStatusTableHeader);
+			header.slotSize = sizeof(sStatusSlot);
+			header.capacity = capacity;
+			header.pid = (uint32_t)getpid();
+			std::atomic_thread_fence(std::memory_order_release);
+			std::memcpy(header.magic, sStatusTableHeader::s_magic, sizeof(header.magic));	// valid from now on
+			m_last.reserve(capacity);
+		}
+		xStatusTable(xStatusTable const&) = delete;
+		xStatusTable& operator = (xStatusTable const&) = delete;
+		~xStatusTable() { Close(); }
+
+		uint32_t Capacity() const { return Header().capacity; }
+
+		/// @brief writes snapshot into the table. (driver thread. ex, snapshot handler)
+		void Export(sSequenceSnapshot const& snapshot) {
+			auto& header = Header();
+			auto* slots = Slots();
+			auto const n = (uint32_t)std::min<size_t>(snapshot.size(), header.capacity);
+			header.summary.BeginStore();	// (until the summary is written. Sample())
+			if (m_last.size() > n)
+				m_last.resize(n);
+			for (uint32_t i = 0; i < n; i++) {
+				auto const& node = snapshot[i];
+				sStatusRecord r;
+				r.parent = node.parent;
+				r.nChild = node.nChild;
+				r.state = (uint8_t)node.state;
+				r.depth = (uint8_t)std::min<uint32_t>(node.depth, 0xff);
+				r.nameHash = HashStatusName(node.name);
+				r.tNextDispatch = ToNS(node.tNextDispatch);
+				r.tNextDispatchLatest = ToNS(node.tNextDispatchLatest);
+				r.nResume = node.nResume;
+				auto const len = std::min(node.name.size(), sizeof(r.name) - 1);
+				std::memcpy(r.name, node.name.data(), len);
+				if (i < m_last.size()) {
+					if (m_last[i] == r)
+						continue;
+					m_last[i] = r;
+				}
+				else {
+					m_last.push_back(r);
+				}
+				slots[i].Store(r);
+			}
+			sStatusSummary summary{
+				.nSlot = n,
+				.pid = (uint32_t)getpid(),
+				.generation = snapshot.generation,
+				.tExported = ToNS(snapshot.tTaken),
+				.durBuild = std::chrono::duration_cast<std::chrono::nanoseconds>(snapshot.durBuild).count(),
+				.nOverflow = snapshot.size() - n,
+			};
+			for (size_t s = 0; s < summary.nState.size(); s++)
+				summary.nState[s] = snapshot.nState[s];
+			header.summary.EndStore(summary);
+		}
+
+		static int64_t ToNS(clock_t::time_point t) {
+			if (t == clock_t::time_point::max())
+				return INT64_MAX;
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+		}
+
+	protected:
+		/// @brief true if 'name' is a status table whose exporter is not running any more.
+		/// (anything else, ex. a table being created, is left alone)
+		static bool IsStale(std::string const& name) {
+			int fd = shm_open(name.c_str(), O_RDONLY, 0);
+			if (fd < 0)
+				return false;
+			bool bStale{};
+			struct stat st{};
+			if (fstat(fd, &st) == 0 and (size_t)st.st_size >= sizeof(sStatusTableHeader)) {
+				if (auto* base = mmap(nullptr, sizeof(sStatusTableHeader), PROT_READ, MAP_SHARED, fd, 0); base != MAP_FAILED) {
+					auto const& header = *(sStatusTableHeader const*)base;
+					std::atomic_thread_fence(std::memory_order_acquire);
+					if (std::memcmp(header.magic, sStatusTableHeader::s_magic, sizeof(header.magic)) == 0 and header.version == sStatusTableHeader::s_version)
+						bStale = kill((pid_t)header.pid, 0) < 0 and errno == ESRCH;
+					munmap(base, sizeof(sStatusTableHeader));
+				}
+			}
+			close(fd);
+			return bStale;
+		}
+		sStatusTableHeader& Header() const { return *(sStatusTableHeader*)m_base; }
+		sStatusSlot* Slots() const { return (sStatusSlot*)((char*)m_base + sizeof(sStatusTableHeader)); }
+		void Close() {
+			if (m_base)
+				munmap(std::exchange(m_base, nullptr), m_size);
+			if (m_fd >= 0)
+				close(std::exchange(m_fd, -1));
+			if (m_bUnlink and !m_name.empty())
+				shm_unlink(m_name.c_str());
+		}
+	};
+
+	//-------------------------------------------------------------------------
+	/// @brief reader. (other processes : dashboards, supervisor, cli) maps the table read-only.
+	/// sampling never makes a system call, nor blocks the exporter. each record is consistent by itself, and Sample() reads all of one export.
+	/// reads give up (nullopt) if the exporter stays in the middle of writing. (ex, it died while exporting)
+	class xStatusTableReader {
+	protected:
+		int m_fd{-1};
+		void const* m_base{};
+		size_t m_size{};
+
+	public:
+		/// @brief opens the table. throws if not found, or layout mismatches
+		explicit xStatusTableReader(std::string const& name) {
+			m_fd = shm_open(name.c_str(), O_RDONLY, 0);
+			if (m_fd < 0)
+				throw xException("xStatusTableReader : shm_open() failed. " + std::string(strerror(errno)));
+			struct stat st{};
+			if (fstat(m_fd, &st) < 0 or (size_t)st.st_size < sizeof(sStatusTableHeader)) {
+				Close();
+				throw xException("xStatusTableReader : not a status table");
+			}
+			m_size = (size_t)st.st_size;
+			m_base = mmap(nullptr, m_size, PROT_READ, MAP_SHARED, m_fd, 0);
+			if (m_base == MAP_FAILED) {
+				m_base = nullptr;
+				Close();
+				throw xException("xStatusTableReader : mmap() failed. " + std::string(strerror(errno)));
+			}
+			auto const& header = Header();
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (std::memcmp(header.magic, sStatusTableHeader::s_magic, sizeof(header.magic))
+				or header.version != sStatusTableHeader::s_version
+				or header.headerSize != sizeof(sStatusTableHeader)
+				or header.slotSize != sizeof(sStatusSlot)
+				or sizeof(sStatusTableHeader) + (size_t)header.capacity * sizeof(sStatusSlot) > m_size)
+			{
+				Close();
+				throw xException("xStatusTableReader : layout mismatch");
+			}
+		}
+		xStatusTableReader(xStatusTableReader const&) = delete;
+		xStatusTableReader& operator = (xStatusTableReader const&) = delete;
+		~xStatusTableReader() { Close(); }
+
+		uint32_t Capacity() const { return Header().capacity; }
+		std::optional<sStatusSummary> GetSummary() const { return Header().summary.Load(); }
+		std::optional<sStatusRecord> GetRecord(uint32_t index) const { return Slots()[index].Load(); }
+
+		/// @brief reads all used records of one export. (retried if the exporter writes in the meantime)
+		std::optional<sStatusSummary> Sample(std::vector<sStatusRecord>& records) const {
+			return Header().summary.LoadWith([&](sStatusSummary const& summary) {
+				auto const n = std::min(summary.nSlot, Capacity());
+				records.resize(n);
+				for (uint32_t i = 0; i < n; i++) {
+					auto record = GetRecord(i);
+					if (!record)
+						return false;
+					records[i] = *record;
+				}
+				return true;
+			});
+		}
+
+	protected:
+		sStatusTableHeader const& Header() const { return *(sStatusTableHeader const*)m_base; }
+		sStatusSlot const* Slots() const { return (sStatusSlot const*)((char const*)m_base + sizeof(sStatusTableHeader)); }
+		void Close() {
+			if (m_base)
+				munmap(const_cast<void*>(std::exchange(m_base, nullptr)), m_size);
+			if (m_fd >= 0)
+				close(std::exchange(m_fd, -1));
+		}
+	};
+
+}	// namespace gtl::seq::inline v01
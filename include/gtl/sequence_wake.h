@@ -0,0 +1,255 @@
+#pragma once
+
+//////////////////////////////////////////////////////////////////////
+//
+// sequence_wake.h: waking up parked sequences from other threads (lock-free)
+//
+// PWH
+// 2026-10-18
+//
+//////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <utility>
+
+#include "sequence_coroutine_handle.h"
+
+namespace gtl::seq::inline v01 {
+
+	class xWakeQueue;
+
+	//-------------------------------------------------------------------------
+	/// @brief wake-up node of a sequence. shared by the sequence and whoever wakes it up.
+	/// created on the driver thread. Wake() can be called from any thread.
+	/// the node shares the driver's queue : waking it after the driver is destroyed does nothing. (the queue is closed)
+	struct sWakeNode : public std::enable_shared_from_this<sWakeNode> {
+		std::shared_ptr<xWakeQueue> queue;		// driver's queue
+		void* seq{};							// owner sequence. accessed only on the driver thread. (nullptr if destroyed)
+		void (*fnResume)(void* seq){};			// called on the driver thread
+		std::atomic<bool> bQueued{};
+		std::atomic<bool> bSignaled{};			// xWakeHandle::Wake(). consumed by the sequence (WaitWake())
+		std::atomic<uint32_t> nWake{};			// wake-ups. (Wake(), queued or not, and Resume()) tells wake-ups of the current park from stale ones
+		sWakeNode* next{};
+		std::shared_ptr<sWakeNode> keepalive;	// while queued
+
+		/// @brief pushes this node to the driver's wake queue, and notifies driver. (no lock)
+		/// @return false if already queued. (counted anyway : the queued node resumes the sequence for it)
+		bool Wake();
+		/// @brief resumes the sequence now, as a drained wake-up does. (driver thread. a retry node of an awaiter, done retrying)
+		void Resume() {
+			nWake.fetch_add(1, std::memory_order_acq_rel);
+			if (seq)
+				fnResume(seq);
+		}
+	};
+
+	//-------------------------------------------------------------------------
+	/// @brief driver's wake queue and mailbox. (multi producer, single consumer. lock-free)
+	/// owned by the driver (Create() ... Close()) and shared by wake nodes. so it outlives the driver while nodes refer to it.
+	/// once closed (the driver is destroyed), Push() and Post() refuse. nothing is queued that nobody would drain.
+	class xWakeQueue : public std::enable_shared_from_this<xWakeQueue> {
+	protected:
+		struct sMail {
+			std::function<void()> task;
+			sMail* next{};
+		};
+		inline static sWakeNode s_closed;	// head of a closed queue
+		inline static sMail s_closedMail{ .task = {}, .next = nullptr };
+		std::atomic<sWakeNode*> m_head{};
+		std::atomic<sMail*> m_headMail{};
+		std::atomic<std::function<void()>*> m_fnNotify{};	// wakes up driver loop. (published atomically, SetNotifier())
+		mutable std::atomic<uint32_t> m_nNotifying{};	// Notify() calls running
+		std::shared_ptr<xWakeQueue> m_self;	// reference of the driver. released by Close()
+
+	public:
+		xWakeQueue() = default;
+		xWakeQueue(xWakeQueue const&) = delete;
+		xWakeQueue& operator = (xWakeQueue const&) = delete;
+		~xWakeQueue() {
+			Clear();
+			delete m_fnNotify.exchange(nullptr);
+		}
+
+		/// @brief new queue referenced by the driver until Close()
+		static xWakeQueue* Create() {
+			auto queue = std::make_shared<xWakeQueue>();
+			queue->m_self = queue;
+			return queue.get();
+		}
+		/// @brief driver is gone. refuses wake-ups and posts from now on, releases what is queued, and drops the driver's reference. (driver thread)
+		/// the queue may be destroyed on return.
+		void Close() {
+			SetNotifier(nullptr);	// (waits for running notifications)
+			Clear();
+			auto self = std::move(m_self);
+		}
+
+		/// @return false if the queue is closed
+		bool Push(sWakeNode* node) {
+			auto* head = m_head.load(std::memory_order_relaxed);
+			do {
+				if (head == &s_closed)
+					return false;
+				node->next = head;
+			} while (!m_head.compare_exchange_weak(head, node, std::memory_order_release, std::memory_order_relaxed));
+			return true;
+		}
+		/// @brief calls notifier. can be called from any thread. (no lock)
+		void Notify() const {
+			m_nNotifying.fetch_add(1);
+			if (auto* fn = m_fnNotify.load())
+				(*fn)();
+			m_nNotifying.fetch_sub(1);
+		}
+		/// @brief replaces notifier. can be called while other threads call Notify() :
+		/// returns after notifications running with the previous notifier are done. (so whatever it refers to can be destroyed)
+		/// @return previous notifier
+		std::function<void()> SetNotifier(std::function<void()> fnNotify) {
+			auto* old = m_fnNotify.exchange(fnNotify ? new std::function<void()>(std::move(fnNotify)) : nullptr);
+			while (m_nNotifying.load())
+				std::this_thread::yield();
+			std::function<void()> fnOld;
+			if (old) {
+				fnOld = std::move(*old);
+				delete old;
+			}
+			return fnOld;
+		}
+		/// @brief posts a task to be run on the driver thread. (does not notify)
+		/// @return false if the queue is closed. (the task is destroyed without being run)
+		bool Post(std::function<void()> task) {
+			auto* mail = new sMail{ .task = std::move(task) };
+			auto* head = m_headMail.load(std::memory_order_relaxed);
+			do {
+				if (head == &s_closedMail) {
+					delete mail;
+					return false;
+				}
+				mail->next = head;
+			} while (!m_headMail.compare_exchange_weak(head, mail, std::memory_order_release, std::memory_order_relaxed));
+			return true;
+		}
+		bool Empty() const {
+			auto* head = m_head.load(std::memory_order_relaxed);
+			auto* headMail = m_headMail.load(std::memory_order_relaxed);
+			return (!head or head == &s_closed) and (!headMail or headMail == &s_closedMail);
+		}
+
+		/// @brief runs posted tasks, and resumes (ReserveResume) all queued sequences in FIFO order. driver thread only.
+		/// @return number of tasks and nodes
+		size_t Drain() {
+			size_t count{};
+			if (Empty())
+				return count;	// (or closed)
+			if (auto* mail = m_headMail.exchange(nullptr, std::memory_order_acquire)) {
+				sMail* prev{};
+				while (mail)
+					mail = std::exchange(mail->next, std::exchange(prev, mail));
+				for (mail = prev; mail; count++) {
+					std::unique_ptr<sMail> cur{std::exchange(mail, mail->next)};
+					cur->task();
+				}
+			}
+
+			auto* node = m_head.exchange(nullptr, std::memory_order_acquire);
+			if (!node)
+				return count;
+			// reverse (LIFO -> FIFO)
+			sWakeNode* prev{};
+			while (node)
+				node = std::exchange(node->next, std::exchange(prev, node));
+			for (node = prev; node; count++) {
+				auto keep = std::move(node->keepalive);
+				auto* next = node->next;
+				node->bQueued.store(false, std::memory_order_release);
+				if (node->seq)
+					node->fnResume(node->seq);
+				node = next;
+			}
+			return count;
+		}
+
+	protected:
+		/// @brief closes the lists, and releases posted tasks and queued nodes. (nodes keep themselves alive while queued)
+		void Clear() {
+			for (auto* mail = m_headMail.exchange(&s_closedMail, std::memory_order_acquire); mail and mail != &s_closedMail; )
+				delete std::exchange(mail, mail->next);
+			for (auto* node = m_head.exchange(&s_closed, std::memory_order_acquire); node and node != &s_closed; ) {
+				auto keep = std::move(node->keepalive);
+				node->bQueued.store(false, std::memory_order_release);
+				node = std::exchange(node->next, nullptr);
+			}
+		}
+	};
+
+	//-------------------------------------------------------------------------
+	/// @brief copyable handle to wake up a sequence parked at co_await seq.WaitWake(). (seq.GetWakeHandle())
+	/// Wake() can be called from any thread. no lock, no allocation : sets a flag and pushes the node to the driver's wake queue.
+	/// it is async-signal-safe if the driver's notifier is. (ex, xDispatchFD : write to eventfd)
+	/// the handle keeps the node (and the driver's queue) alive. waking a destroyed sequence, or after its driver is destroyed, does nothing.
+	class xWakeHandle {
+	protected:
+		std::shared_ptr<sWakeNode> m_node;
+	public:
+		xWakeHandle() = default;
+		explicit xWakeHandle(std::shared_ptr<sWakeNode> node) : m_node(std::move(node)) {}
+
+		explicit operator bool() const { return (bool)m_node; }
+
+		/// @brief sets signaled flag and resumes the sequence at the next Dispatch() if it is waiting. (WaitWake())
+		/// a wake-up while the sequence is not waiting is kept, and the next WaitWake() returns at once.
+		/// @return false if already signaled (not consumed yet) or empty handle
+		bool Wake() const noexcept {
+			if (!m_node or m_node->bSignaled.exchange(true, std::memory_order_acq_rel))
+				return false;
+			m_node->Wake();
+			return true;
+		}
+		bool IsSignaled() const { return m_node and m_node->bSignaled.load(std::memory_order_acquire); }
+	};
+
+	//-------------------------------------------------------------------------
+	/// @brief type-erased current sequence of this thread. set by the driver while resuming a sequence.
+	/// for awaitables which don't know the sequence type (futures, channels ...)
+	struct sCurrentSequence {
+		using fnGetWakeNode_t = std::shared_ptr<sWakeNode> const& (*)(void* seq);
+		using fnReserveResume_t = void (*)(void* seq, clock_t::duration dur);
+
+		inline thread_local static void* s_seq{};
+		inline thread_local static fnGetWakeNode_t s_fnGetWakeNode{};
+		inline thread_local static fnReserveResume_t s_fnReserveResume{};
+
+		/// @brief wake-up node of the current sequence, which is marked parked on it. (call from await_suspend) throws if not called from a sequence.
+		/// the node resumes the sequence only while it is parked. (wake-ups after the sequence was resumed otherwise are ignored)
+		static std::shared_ptr<sWakeNode> const& GetWakeNode() {
+			if (!s_seq) [[ unlikely ]]
+				throw xException("must be called from sequence function");
+			return s_fnGetWakeNode(s_seq);
+		}
+		/// @brief reserves resume of the current sequence after dur. (timeout of a parking awaiter)
+		static void ReserveResume(clock_t::duration dur) {
+			if (!s_seq) [[ unlikely ]]
+				throw xException("must be called from sequence function");
+			s_fnReserveResume(s_seq, dur);
+		}
+	};
+
+	//-------------------------------------------------------------------------
+	inline bool sWakeNode::Wake() {
+		nWake.fetch_add(1, std::memory_order_acq_rel);
+		if (bQueued.exchange(true, std::memory_order_acq_rel))
+			return false;
+		keepalive = shared_from_this();
+		if (!queue->Push(this)) {
+			auto keep = std::move(keepalive);	// closed. (bQueued stays set : later wake-ups return at once)
+			return false;
+		}
+		queue->Notify();
+		return true;
+	}
+
+}	// namespace gtl::seq::inline v01